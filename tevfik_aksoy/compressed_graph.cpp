@@ -0,0 +1,160 @@
+#include "compressed_graph.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace {
+using uni_cpp_practice::VertexId;
+
+// Signed differences map to 0, -1, 1, -2, 2, ... -> 0, 1, 2, 3, 4, ...
+std::uint64_t encode_zigzag(std::int64_t value) {
+  return (static_cast<std::uint64_t>(value) << 1) ^
+         static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t decode_zigzag(std::uint64_t value) {
+  return static_cast<std::int64_t>(value >> 1) ^
+         -static_cast<std::int64_t>(value & 1);
+}
+
+void write_varint(std::uint64_t value, std::vector<std::uint8_t>& bytes) {
+  while (value >= 0x80) {
+    bytes.push_back(static_cast<std::uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  bytes.push_back(static_cast<std::uint8_t>(value));
+}
+
+// Returns the position after the varint.
+const std::uint8_t* read_varint(const std::uint8_t* position,
+                                std::uint64_t& value) {
+  value = *position & 0x7F;
+  for (int shift = 7; *position++ & 0x80; shift += 7) {
+    value |= static_cast<std::uint64_t>(*position & 0x7F) << shift;
+  }
+  return position;
+}
+}  // namespace
+
+namespace uni_cpp_practice {
+
+CompressedGraph::AdjacentVertexIdRange::Iterator::Iterator(
+    const std::uint8_t* position,
+    const std::uint8_t* end,
+    const VertexId& vertex_id)
+    : position_(position), next_position_(position), end_(end) {
+  if (position_ != end_) {
+    std::uint64_t difference = 0;
+    next_position_ = read_varint(position_, difference);
+    vertex_id_ = vertex_id + decode_zigzag(difference);
+  }
+}
+
+CompressedGraph::AdjacentVertexIdRange::Iterator&
+CompressedGraph::AdjacentVertexIdRange::Iterator::operator++() {
+  position_ = next_position_;
+  if (position_ != end_) {
+    std::uint64_t gap = 0;
+    next_position_ = read_varint(position_, gap);
+    vertex_id_ += gap;
+  }
+  return *this;
+}
+
+CompressedGraph::CompressedGraph(const Graph& graph,
+                                 EdgeDirection direction)
+    : depth_layout_(graph) {
+  const auto vertices_count = graph.vertex_ids_count();
+  std::vector<std::size_t> offsets;
+  offsets.reserve(vertices_count + 1);
+  offsets.push_back(0);
+  std::vector<VertexId> vertex_ids;
+  for (VertexId vertex_id = 0; vertex_id < vertices_count; vertex_id++) {
+    if (graph.does_vertex_exist(vertex_id)) {
+      vertex_ids.clear();
+      for (const auto& neighbor : graph.neighbors(vertex_id)) {
+        if (direction == EdgeDirection::Both ||
+            direction == neighbor.direction)
+          vertex_ids.push_back(neighbor.vertex_id);
+      }
+      std::sort(vertex_ids.begin(), vertex_ids.end());
+      auto previous_vertex_id = vertex_id;
+      for (std::size_t i = 0; i < vertex_ids.size(); i++) {
+        write_varint(
+            i == 0 ? encode_zigzag(static_cast<std::int64_t>(vertex_ids[i]) -
+                                   static_cast<std::int64_t>(vertex_id))
+                   : vertex_ids[i] - previous_vertex_id,
+            adjacent_vertex_ids_);
+        previous_vertex_id = vertex_ids[i];
+      }
+    }
+    offsets.push_back(adjacent_vertex_ids_.size());
+  }
+  adjacent_vertex_ids_.shrink_to_fit();
+  set_offsets(offsets);
+}
+
+void CompressedGraph::set_offsets(const std::vector<std::size_t>& offsets) {
+  const auto offsets_count = offsets.size();
+  block_offsets_.reserve((offsets_count + BLOCK_SIZE - 1) / BLOCK_SIZE);
+  vertex_offsets_.reserve(offsets_count);
+  for (std::size_t first = 0; first < offsets_count; first += BLOCK_SIZE) {
+    const auto end = std::min(first + BLOCK_SIZE, offsets_count);
+    const auto block_offset = offsets[first];
+    if (offsets[end - 1] - block_offset <= UINT16_MAX) {
+      block_offsets_.push_back(block_offset);
+      for (auto i = first; i < end; i++) {
+        vertex_offsets_.push_back(
+            static_cast<std::uint16_t>(offsets[i] - block_offset));
+      }
+    } else {
+      block_offsets_.push_back(WIDE_BLOCK_FLAG | wide_offsets_.size());
+      wide_offsets_.insert(wide_offsets_.end(), offsets.begin() + first,
+                           offsets.begin() + end);
+      vertex_offsets_.resize(end);
+    }
+  }
+  wide_offsets_.shrink_to_fit();
+}
+
+std::size_t CompressedGraph::get_offset(const VertexId& vertex_id) const {
+  const auto block_offset = block_offsets_[vertex_id / BLOCK_SIZE];
+  if (block_offset & WIDE_BLOCK_FLAG)
+    return wide_offsets_[(block_offset & ~WIDE_BLOCK_FLAG) +
+                         vertex_id % BLOCK_SIZE];
+  return block_offset + vertex_offsets_[vertex_id];
+}
+
+bool CompressedGraph::does_vertex_exist(const VertexId& id) const {
+  return id < vertices_count();
+}
+
+VertexId CompressedGraph::vertices_count() const {
+  return vertex_offsets_.size() - 1;
+}
+
+int CompressedGraph::depth() const {
+  return depth_layout_.depth();
+}
+
+CompressedGraph::AdjacentVertexIdRange CompressedGraph::get_adjacent_vertex_ids(
+    const VertexId& vertex_id) const {
+  assert(does_vertex_exist(vertex_id) && "Vertex doesn't exist!");
+  const auto* adjacent_vertex_ids = adjacent_vertex_ids_.data();
+  return AdjacentVertexIdRange(adjacent_vertex_ids + get_offset(vertex_id),
+                               adjacent_vertex_ids + get_offset(vertex_id + 1),
+                               vertex_id);
+}
+
+VertexIdRange CompressedGraph::get_vertices_in_depth(
+    const VertexDepth& depth) const {
+  return depth_layout_.get_vertices_in_depth(depth);
+}
+
+std::size_t CompressedGraph::reserved_bytes() const {
+  return sizeof(CompressedGraph) +
+         block_offsets_.capacity() * sizeof(std::size_t) +
+         vertex_offsets_.capacity() * sizeof(std::uint16_t) +
+         wide_offsets_.capacity() * sizeof(std::size_t) +
+         adjacent_vertex_ids_.capacity() + depth_layout_.reserved_bytes();
+}
+}  // namespace uni_cpp_practice
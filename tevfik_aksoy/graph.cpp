@@ -1,192 +1,656 @@
-#include "graph.hpp"
-#include <cassert>
-#include <iostream>
-
-namespace {
-bool is_depth_valid(
-    int depth,
-    const std::vector<std::vector<uni_cpp_practice::VertexId>>& depth_map) {
-  if (depth > depth_map.size())
-    return false;
-  if (depth_map[depth].empty())
-    return false;
-  return true;
-}
-}  // namespace
-
-namespace uni_cpp_practice {
-
-void Vertex::add_edge_id(const EdgeId& id) {
-  assert(!has_edge_id(id, edge_ids_) && "Edge already exists in vertex!");
-  edge_ids_.push_back(id);
-}
-
-const std::vector<EdgeId>& Vertex::get_edge_ids() const {
-  return edge_ids_;
-}
-
-std::string color_to_string(const Edge::Color& color) {
-  switch (color) {
-    case Edge::Color::Gray:
-      return "gray";
-    case Edge::Color::Green:
-      return "green";
-    case Edge::Color::Blue:
-      return "blue";
-    case Edge::Color::Yellow:
-      return "yellow";
-    case Edge::Color::Red:
-      return "red";
-  }
-}
-
-bool Graph::does_vertex_exist(const VertexId& id) const {
-  for (const auto& vertex : vertices_)
-    if (vertex.id == id) {
-      return true;
-    }
-  return false;
-}
-
-VertexId Graph::insert_vertex() {
-  const auto id = get_new_vertex_id();
-  vertices_.emplace_back(id);
-  if (id == 0) {
-    depth_map_.emplace_back();
-    depth_map_[0].push_back(id);
-  }
-  return id;
-}
-
-Edge::Color Graph::calculate_color_for_edge(const Vertex& source,
-                                            const Vertex& destination) const {
-  if (source.get_edge_ids().empty() || destination.get_edge_ids().empty()) {
-    return Edge::Color::Gray;
-  }
-  if (source.id == destination.id)
-    return Edge::Color::Green;
-  if (source.depth == destination.depth) {
-    for (int i = 0; i < depth_map_[source.depth].size() - 1; i++) {
-      const auto first = depth_map_[source.depth][i];
-      const auto second = depth_map_[source.depth][i + 1];
-      if ((source.id == first && destination.id == second) ||
-          (destination.id == first && source.id == second))
-        return Edge::Color::Blue;
-    }
-  }
-  if (source.depth == destination.depth - 1)
-    return Edge::Color::Yellow;
-  if (source.depth == destination.depth - 2)
-    return Edge::Color::Red;
-
-  throw std::runtime_error("Failed to calculate edge color");
-}
-
-const Vertex& Graph::get_vertex(const VertexId& id) const {
-  for (auto& vertex : vertices_) {
-    if (id == vertex.id)
-      return vertex;
-  }
-  throw std::runtime_error("Vertex not found!");
-}
-
-const Edge& Graph::get_edge(const EdgeId& id) const {
-  for (auto& edge : edges_) {
-    if (id == edge.id)
-      return edge;
-  }
-  throw std::runtime_error("Edge not found!");
-}
-
-void Graph::insert_edge(const VertexId& source_id,
-                        const VertexId& destination_id) {
-  assert(does_vertex_exist(source_id) && "Source vertex doesn't exist!");
-  assert(does_vertex_exist(destination_id) &&
-         "Destination vertex doesn't exist!");
-  assert(!are_vertices_connected(source_id, destination_id) &&
-         "Vertices are already connected!");
-  const auto& source_vertex = get_vertex(source_id);
-  const auto& destination_vertex = get_vertex(destination_id);
-  const auto color =
-      calculate_color_for_edge(source_vertex, destination_vertex);
-  const int edge_id = get_new_edge_id();
-  colored_edges_map_[color].push_back(edge_id);
-  edges_.emplace_back(source_id, destination_id, edge_id, color);
-
-  vertices_[source_id].add_edge_id(edge_id);
-  if (color != Edge::Color::Green) {
-    vertices_[destination_id].add_edge_id(edge_id);
-    if (color == Edge::Color::Gray) {
-      const auto depth = vertices_[source_id].depth + 1;
-      vertices_[destination_id].depth = depth;
-      if (depth_map_.size() == depth) {
-        depth_map_.emplace_back();
-      }
-      depth_map_[depth].emplace_back(destination_id);
-    }
-  }
-}
-
-bool Graph::are_vertices_connected(const VertexId& source,
-                                   const VertexId& destination) const {
-  assert(does_vertex_exist(source) && "Source vertex doesn't exist!");
-  assert(does_vertex_exist(destination) && "Destination vertex doesn't exist!");
-
-  const auto& source_vertex_edges = vertices_[source].get_edge_ids();
-  const auto& destination_vertex_edges = vertices_[destination].get_edge_ids();
-  for (const auto& edge_of_source_vertex : source_vertex_edges)
-    if (source == destination) {
-      if (edges_[edge_of_source_vertex].source ==
-          edges_[edge_of_source_vertex].destination)
-        return true;
-    } else {
-      for (const auto& edge_of_destination_vertex : destination_vertex_edges)
-        if (edge_of_source_vertex == edge_of_destination_vertex)
-          return true;
-    }
-  return false;
-}
-
-std::vector<VertexId> Graph::get_adjacent_vertex_ids(
-    const VertexId& vertex_id) const {
-  std::vector<VertexId> adjacent_vertices;
-  const auto& vertex = std::move(get_vertex(vertex_id));
-  const auto vertex_edges = vertex.get_edge_ids();
-
-  for (const auto& edge_id : vertex_edges) {
-    Edge edge = get_edge(edge_id);
-    const auto connected_vertex_id =
-        edge.source == vertex.id ? edge.destination : edge.source;
-    adjacent_vertices.push_back(connected_vertex_id);
-  }
-
-  return adjacent_vertices;
-}
-
-const std::vector<EdgeId>& Graph::get_colored_edges(
-    const Edge::Color& color) const {
-  if (colored_edges_map_.find(color) == colored_edges_map_.end()) {
-    static std::vector<EdgeId> empty_result;
-    return empty_result;
-  }
-  return colored_edges_map_.at(color);
-}
-
-int Graph::depth() const {
-  return depth_map_.size() - 1;
-}
-
-const std::vector<Vertex>& Graph::get_vertices() const {
-  return vertices_;
-}
-
-const std::vector<Edge>& Graph::get_edges() const {
-  return edges_;
-}
-
-const std::vector<VertexId>& Graph::get_vertices_in_depth(
-    const VertexDepth& depth) const {
-  assert(is_depth_valid(depth, depth_map_) && "Depth is not valid!");
-  return depth_map_.at(depth);
-}
-}  // namespace uni_cpp_practice
+#include "graph.hpp"
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <numeric>
+
+namespace {
+template <typename Vector>
+std::size_t get_capacity_bytes(const Vector& vector) {
+  return vector.capacity() * sizeof(typename Vector::value_type);
+}
+}  // namespace
+
+namespace uni_cpp_practice {
+
+EdgeIdList::EdgeIdList(EdgeIdList&& other) noexcept
+    : size_(other.size_), capacity_(other.capacity_) {
+  if (other.is_spilled()) {
+    spilled_ids_ = other.spilled_ids_;
+  } else {
+    std::copy(other.inline_ids_, other.inline_ids_ + size_, inline_ids_);
+  }
+  other.size_ = 0;
+  other.capacity_ = INLINE_CAPACITY;
+}
+
+EdgeIdList& EdgeIdList::operator=(EdgeIdList&& other) noexcept {
+  if (this != &other) {
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    if (other.is_spilled()) {
+      spilled_ids_ = other.spilled_ids_;
+    } else {
+      std::copy(other.inline_ids_, other.inline_ids_ + size_, inline_ids_);
+    }
+    other.size_ = 0;
+    other.capacity_ = INLINE_CAPACITY;
+  }
+  return *this;
+}
+
+void EdgeIdList::reserve(EdgeId capacity,
+                         std::pmr::memory_resource& resource) {
+  if (capacity <= capacity_) {
+    return;
+  }
+  auto* const ids = static_cast<EdgeId*>(
+      resource.allocate(capacity * sizeof(EdgeId), alignof(EdgeId)));
+  std::copy(begin(), end(), ids);
+  if (is_spilled()) {
+    resource.deallocate(spilled_ids_, capacity_ * sizeof(EdgeId),
+                        alignof(EdgeId));
+  }
+  spilled_ids_ = ids;
+  capacity_ = capacity;
+}
+
+void EdgeIdList::insert(EdgeId index,
+                        const EdgeId& id,
+                        std::pmr::memory_resource& resource) {
+  if (size_ == capacity_)
+    reserve(2 * capacity_, resource);
+  auto* const ids = data();
+  std::copy_backward(ids + index, ids + size_, ids + size_ + 1);
+  ids[index] = id;
+  size_++;
+}
+
+void EdgeIdList::erase(const EdgeId& id) {
+  auto* const ids = data();
+  auto* const found = std::find(ids, ids + size_, id);
+  if (found != ids + size_) {
+    std::copy(found + 1, ids + size_, found);
+    size_--;
+  }
+}
+
+std::string color_to_string(const Edge::Color& color) {
+  switch (color) {
+    case Edge::Color::Gray:
+      return "gray";
+    case Edge::Color::Green:
+      return "green";
+    case Edge::Color::Blue:
+      return "blue";
+    case Edge::Color::Yellow:
+      return "yellow";
+    case Edge::Color::Red:
+      return "red";
+  }
+}
+
+ConnectionKey::ConnectionKey(const VertexId& first, const VertexId& second)
+    : first_(std::min(first, second)), second_(std::max(first, second)) {}
+
+std::size_t ConnectionKey::Hash::operator()(const ConnectionKey& key) const {
+  return std::hash<std::uint64_t>()(
+      static_cast<std::uint64_t>(key.first_) * 0x9E3779B97F4A7C15ull ^
+      key.second_);
+}
+
+Graph::Graph() : arena_(std::make_unique<GraphArena>()) {}
+
+void Graph::release_containers() {
+  vertex_depths_ = std::pmr::vector<VertexDepth>(arena_.get());
+  vertex_positions_in_depth_ = std::pmr::vector<VertexId>(arena_.get());
+  vertex_edge_ids_ = std::pmr::vector<EdgeIdList>(arena_.get());
+  is_vertex_removed_ = std::pmr::vector<char>(arena_.get());
+  edge_sources_ = std::pmr::vector<VertexId>(arena_.get());
+  edge_destinations_ = std::pmr::vector<VertexId>(arena_.get());
+  edge_colors_ = std::pmr::vector<Edge::Color>(arena_.get());
+  is_edge_removed_ = std::pmr::vector<char>(arena_.get());
+  depth_vertex_ids_ =
+      std::pmr::vector<std::pmr::vector<VertexId>>(arena_.get());
+  for (auto& edge_ids : colored_edges_) {
+    edge_ids = std::pmr::vector<EdgeId>(arena_.get());
+  }
+}
+
+void Graph::clear() {
+  clear(0);
+}
+
+void Graph::clear(std::size_t arena_bytes) {
+  release_containers();
+  arena_->reset(arena_bytes);
+  vertex_id_counter_ = 0;
+  edge_id_counter_ = 0;
+  removed_vertices_count_ = 0;
+  removed_edges_count_ = 0;
+}
+
+bool Graph::does_vertex_exist(const VertexId& id) const {
+  return id < vertex_ids_count() && !is_vertex_removed_[id];
+}
+
+bool Graph::does_edge_exist(const EdgeId& id) const {
+  return id < edge_ids_count() && !is_edge_removed_[id];
+}
+
+bool Graph::is_vertex_layered(const VertexId& id) const {
+  const auto depth = vertex_depths_[id];
+  if (depth >= depth_vertex_ids_.size())
+    return false;
+  const auto& vertex_ids = depth_vertex_ids_[depth];
+  const auto position = vertex_positions_in_depth_[id];
+  return position < vertex_ids.size() && vertex_ids[position] == id;
+}
+
+VertexId Graph::insert_vertex() {
+  const auto id = get_new_vertex_id();
+  vertex_depths_.push_back(0);
+  vertex_positions_in_depth_.push_back(0);
+  vertex_edge_ids_.emplace_back();
+  is_vertex_removed_.push_back(false);
+  if (id == 0) {
+    depth_vertex_ids_.emplace_back().push_back(id);
+  }
+  return id;
+}
+
+Edge::Color Graph::calculate_color_for_edge(
+    const VertexId& source_id,
+    const VertexId& destination_id) const {
+  if (vertex_edge_ids_[source_id].empty() ||
+      vertex_edge_ids_[destination_id].empty()) {
+    return Edge::Color::Gray;
+  }
+  if (source_id == destination_id)
+    return Edge::Color::Green;
+  const auto source_depth = vertex_depths_[source_id];
+  const auto destination_depth = vertex_depths_[destination_id];
+  if (source_depth == destination_depth) {
+    const auto source_position = vertex_positions_in_depth_[source_id];
+    const auto destination_position =
+        vertex_positions_in_depth_[destination_id];
+    if (source_position + 1 == destination_position ||
+        destination_position + 1 == source_position)
+      return Edge::Color::Blue;
+  }
+  if (source_depth == destination_depth - 1)
+    return Edge::Color::Yellow;
+  if (source_depth == destination_depth - 2)
+    return Edge::Color::Red;
+
+  throw std::runtime_error("Failed to calculate edge color");
+}
+
+Vertex Graph::get_vertex(const VertexId& id) const {
+  if (!does_vertex_exist(id))
+    throw std::runtime_error("Vertex not found!");
+  return get_vertex_unchecked(id);
+}
+
+Edge Graph::get_edge(const EdgeId& id) const {
+  if (!does_edge_exist(id))
+    throw std::runtime_error("Edge not found!");
+  return get_edge_unchecked(id);
+}
+
+Vertex Graph::get_vertex_unchecked(const VertexId& id) const {
+  assert(does_vertex_exist(id) && "Vertex doesn't exist!");
+  return Vertex(id, vertex_depths_[id]);
+}
+
+Edge Graph::get_edge_unchecked(const EdgeId& id) const {
+  assert(does_edge_exist(id) && "Edge doesn't exist!");
+  return Edge(edge_sources_[id], edge_destinations_[id], id, edge_colors_[id]);
+}
+
+const EdgeIdList& Graph::get_vertex_edge_ids(
+    const VertexId& id) const {
+  assert(does_vertex_exist(id) && "Vertex doesn't exist!");
+  return vertex_edge_ids_[id];
+}
+
+void Graph::insert_edge(const VertexId& source_id,
+                        const VertexId& destination_id) {
+  assert(does_vertex_exist(source_id) && "Source vertex doesn't exist!");
+  assert(does_vertex_exist(destination_id) &&
+         "Destination vertex doesn't exist!");
+  assert(!are_vertices_connected(source_id, destination_id) &&
+         "Vertices are already connected!");
+  const auto color = calculate_color_for_edge(source_id, destination_id);
+  // Only a new vertex gets a depth, vertices keep the first one they get.
+  const auto is_new_layered_vertex = color == Edge::Color::Gray &&
+                                     vertex_edge_ids_[destination_id].empty() &&
+                                     !is_vertex_layered(destination_id);
+  const auto& source_edge_ids = vertex_edge_ids_[source_id];
+  const EdgeId source_index =
+      find_edge_id(source_id, destination_id) - source_edge_ids.begin();
+  const auto& destination_edge_ids = vertex_edge_ids_[destination_id];
+  const EdgeId destination_index =
+      find_edge_id(destination_id, source_id) - destination_edge_ids.begin();
+  const auto edge_id = get_new_edge_id();
+  colored_edges_[get_color_index(color)].push_back(edge_id);
+  edge_sources_.push_back(source_id);
+  edge_destinations_.push_back(destination_id);
+  edge_colors_.push_back(color);
+  is_edge_removed_.push_back(false);
+
+  vertex_edge_ids_[source_id].insert(source_index, edge_id, *arena_);
+  if (color != Edge::Color::Green)
+    vertex_edge_ids_[destination_id].insert(destination_index, edge_id,
+                                            *arena_);
+  if (is_new_layered_vertex)
+    insert_layered_vertex(destination_id, vertex_depths_[source_id] + 1);
+}
+
+void Graph::insert_layered_vertex(const VertexId& vertex_id,
+                                  const VertexDepth& depth) {
+  // A vertex is only one deeper than the vertex it hangs from, so at most
+  // one new depth starts.
+  if (depth == depth_vertex_ids_.size()) {
+    depth_vertex_ids_.emplace_back();
+  }
+  auto& vertex_ids = depth_vertex_ids_[depth];
+  vertex_depths_[vertex_id] = depth;
+  vertex_positions_in_depth_[vertex_id] = vertex_ids.size();
+  vertex_ids.push_back(vertex_id);
+}
+
+void Graph::remove_edge(const EdgeId& id) {
+  assert(does_edge_exist(id) && "Edge doesn't exist!");
+  const auto source_id = edge_sources_[id];
+  const auto destination_id = edge_destinations_[id];
+  const auto color = edge_colors_[id];
+  vertex_edge_ids_[source_id].erase(id);
+  if (color != Edge::Color::Green)
+    vertex_edge_ids_[destination_id].erase(id);
+  // Edge ids of a color are sorted, they are inserted in the id order.
+  auto& colored_edges = colored_edges_[get_color_index(color)];
+  colored_edges.erase(
+      std::lower_bound(colored_edges.begin(), colored_edges.end(), id));
+  is_edge_removed_[id] = true;
+  removed_edges_count_++;
+}
+
+void Graph::remove_vertex(const VertexId& id) {
+  assert(does_vertex_exist(id) && "Vertex doesn't exist!");
+  while (!vertex_edge_ids_[id].empty()) {
+    const EdgeId edge_id = vertex_edge_ids_[id][0];
+    remove_edge(edge_id);
+  }
+  if (is_vertex_layered(id)) {
+    auto& vertex_ids = depth_vertex_ids_[vertex_depths_[id]];
+    const auto position = vertex_positions_in_depth_[id];
+    for (auto i = position + 1; i < vertex_ids.size(); i++) {
+      vertex_positions_in_depth_[vertex_ids[i]]--;
+    }
+    vertex_ids.erase(vertex_ids.begin() + position);
+    // Deeper depths may stay without vertices, the deepest ones are gone.
+    while (!depth_vertex_ids_.empty() && depth_vertex_ids_.back().empty()) {
+      depth_vertex_ids_.pop_back();
+    }
+  }
+  is_vertex_removed_[id] = true;
+  removed_vertices_count_++;
+}
+
+Graph::IdMaps Graph::compact() {
+  const auto old_vertex_ids_count = vertex_ids_count();
+  const auto old_edge_ids_count = edge_ids_count();
+  IdMaps id_maps;
+  auto& new_vertex_ids = id_maps.new_vertex_ids;
+  auto& new_edge_ids = id_maps.new_edge_ids;
+  if (removed_vertices_count_ == 0 && removed_edges_count_ == 0) {
+    new_vertex_ids.resize(old_vertex_ids_count);
+    new_edge_ids.resize(old_edge_ids_count);
+    std::iota(new_vertex_ids.begin(), new_vertex_ids.end(), VertexId{0});
+    std::iota(new_edge_ids.begin(), new_edge_ids.end(), EdgeId{0});
+    return id_maps;
+  }
+  new_vertex_ids.assign(old_vertex_ids_count, IdMaps::REMOVED_VERTEX_ID);
+  new_edge_ids.assign(old_edge_ids_count, IdMaps::REMOVED_EDGE_ID);
+  VertexId vertices_count = 0;
+  for (VertexId id = 0; id < old_vertex_ids_count; id++) {
+    if (!is_vertex_removed_[id])
+      new_vertex_ids[id] = vertices_count++;
+  }
+  EdgeId edges_count = 0;
+  for (EdgeId id = 0; id < old_edge_ids_count; id++) {
+    if (!is_edge_removed_[id])
+      new_edge_ids[id] = edges_count++;
+  }
+
+  // Everything that stays is copied out, so that the arena can give all
+  // of its memory back and the graph is filled again from scratch.
+  std::vector<VertexDepth> depths;
+  std::vector<VertexId> positions_in_depth;
+  std::vector<EdgeId> edge_id_offsets = {0};
+  std::vector<EdgeId> vertex_edge_ids;
+  depths.reserve(vertices_count);
+  positions_in_depth.reserve(vertices_count);
+  edge_id_offsets.reserve(vertices_count + 1);
+  for (VertexId id = 0; id < old_vertex_ids_count; id++) {
+    if (is_vertex_removed_[id])
+      continue;
+    depths.push_back(vertex_depths_[id]);
+    positions_in_depth.push_back(vertex_positions_in_depth_[id]);
+    for (const auto& edge_id : vertex_edge_ids_[id]) {
+      vertex_edge_ids.push_back(new_edge_ids[edge_id]);
+    }
+    edge_id_offsets.push_back(vertex_edge_ids.size());
+  }
+  std::vector<VertexId> sources;
+  std::vector<VertexId> destinations;
+  std::vector<Edge::Color> colors;
+  sources.reserve(edges_count);
+  destinations.reserve(edges_count);
+  colors.reserve(edges_count);
+  for (EdgeId id = 0; id < old_edge_ids_count; id++) {
+    if (is_edge_removed_[id])
+      continue;
+    sources.push_back(new_vertex_ids[edge_sources_[id]]);
+    destinations.push_back(new_vertex_ids[edge_destinations_[id]]);
+    colors.push_back(edge_colors_[id]);
+  }
+  std::vector<std::vector<VertexId>> depth_vertex_ids;
+  depth_vertex_ids.reserve(depth_vertex_ids_.size());
+  for (const auto& vertex_ids : depth_vertex_ids_) {
+    auto& new_ids = depth_vertex_ids.emplace_back();
+    new_ids.reserve(vertex_ids.size());
+    for (const auto& id : vertex_ids) {
+      new_ids.push_back(new_vertex_ids[id]);
+    }
+  }
+
+  release_containers();
+  arena_->release();
+
+  vertex_depths_.assign(depths.begin(), depths.end());
+  vertex_positions_in_depth_.assign(positions_in_depth.begin(),
+                                    positions_in_depth.end());
+  is_vertex_removed_.assign(vertices_count, false);
+  vertex_edge_ids_.resize(vertices_count);
+  for (VertexId id = 0; id < vertices_count; id++) {
+    auto& edge_ids = vertex_edge_ids_[id];
+    edge_ids.reserve(edge_id_offsets[id + 1] - edge_id_offsets[id], *arena_);
+    for (auto i = edge_id_offsets[id]; i < edge_id_offsets[id + 1]; i++) {
+      edge_ids.push_back(vertex_edge_ids[i], *arena_);
+    }
+  }
+  edge_sources_.assign(sources.begin(), sources.end());
+  edge_destinations_.assign(destinations.begin(), destinations.end());
+  edge_colors_.assign(colors.begin(), colors.end());
+  is_edge_removed_.assign(edges_count, false);
+  depth_vertex_ids_.reserve(depth_vertex_ids.size());
+  for (const auto& vertex_ids : depth_vertex_ids) {
+    depth_vertex_ids_.emplace_back(vertex_ids.begin(), vertex_ids.end());
+  }
+  for (EdgeId id = 0; id < edges_count; id++) {
+    colored_edges_[get_color_index(colors[id])].push_back(id);
+  }
+  vertex_id_counter_ = vertices_count;
+  edge_id_counter_ = edges_count;
+  removed_vertices_count_ = 0;
+  removed_edges_count_ = 0;
+  return id_maps;
+}
+
+bool Graph::are_vertices_connected(const VertexId& source,
+                                   const VertexId& destination) const {
+  assert(does_vertex_exist(source) && "Source vertex doesn't exist!");
+  assert(does_vertex_exist(destination) && "Destination vertex doesn't exist!");
+
+  return !neighbors(source, destination, destination + 1).empty();
+}
+
+const EdgeId* Graph::find_edge_id(const VertexId& vertex_id,
+                                  const VertexId& adjacent_vertex_id) const {
+  const auto& edge_ids = vertex_edge_ids_[vertex_id];
+  return std::lower_bound(
+      edge_ids.begin(), edge_ids.end(), adjacent_vertex_id,
+      [this, &vertex_id](const EdgeId& edge_id, const VertexId& id) {
+        return get_adjacent_vertex_id(edge_id, vertex_id) < id;
+      });
+}
+
+NeighborRange Graph::neighbors(const VertexId& vertex_id) const {
+  const auto& edge_ids = get_vertex_edge_ids(vertex_id);
+  const auto* sources = edge_sources_.data();
+  const auto* destinations = edge_destinations_.data();
+  const auto* colors = edge_colors_.data();
+  return NeighborRange(NeighborRange::Iterator(edge_ids.begin(), vertex_id,
+                                               sources, destinations, colors),
+                       NeighborRange::Iterator(edge_ids.end(), vertex_id,
+                                               sources, destinations, colors),
+                       edge_ids.size());
+}
+
+NeighborRange Graph::neighbors(const VertexId& vertex_id,
+                               const VertexId& first_vertex_id,
+                               const VertexId& end_vertex_id) const {
+  assert(does_vertex_exist(vertex_id) && "Vertex doesn't exist!");
+  const auto* const begin = find_edge_id(vertex_id, first_vertex_id);
+  const auto* const end =
+      first_vertex_id < end_vertex_id ? find_edge_id(vertex_id, end_vertex_id)
+                                      : begin;
+  const auto* sources = edge_sources_.data();
+  const auto* destinations = edge_destinations_.data();
+  const auto* colors = edge_colors_.data();
+  return NeighborRange(
+      NeighborRange::Iterator(begin, vertex_id, sources, destinations, colors),
+      NeighborRange::Iterator(end, vertex_id, sources, destinations, colors),
+      end - begin);
+}
+
+std::vector<VertexId> Graph::get_adjacent_vertex_ids(
+    const VertexId& vertex_id) const {
+  const auto neighbors_range = neighbors(vertex_id);
+  std::vector<VertexId> adjacent_vertices;
+  adjacent_vertices.reserve(neighbors_range.size());
+  for (const auto& neighbor : neighbors_range) {
+    adjacent_vertices.push_back(neighbor.vertex_id);
+  }
+
+  return adjacent_vertices;
+}
+
+const std::pmr::vector<EdgeId>& Graph::get_colored_edges(
+    const Edge::Color& color) const {
+  return colored_edges_[get_color_index(color)];
+}
+
+int Graph::depth() const {
+  return static_cast<int>(depth_vertex_ids_.size()) - 1;
+}
+
+VertexId Graph::vertices_count() const {
+  return vertex_ids_count() - removed_vertices_count_;
+}
+
+EdgeId Graph::edges_count() const {
+  return edge_ids_count() - removed_edges_count_;
+}
+
+VertexId Graph::vertex_ids_count() const {
+  return vertex_depths_.size();
+}
+
+EdgeId Graph::edge_ids_count() const {
+  return edge_colors_.size();
+}
+
+VertexIdRange Graph::get_vertices_in_depth(const VertexDepth& depth) const {
+  assert(depth < depth_vertex_ids_.size() && "Depth is not valid!");
+  const auto& vertex_ids = depth_vertex_ids_[depth];
+  return VertexIdRange(vertex_ids.data(),
+                       vertex_ids.data() + vertex_ids.size());
+}
+
+const std::pmr::vector<VertexDepth>& Graph::get_vertex_depths() const {
+  return vertex_depths_;
+}
+
+const std::pmr::vector<VertexId>& Graph::get_edge_sources() const {
+  return edge_sources_;
+}
+
+const std::pmr::vector<VertexId>& Graph::get_edge_destinations() const {
+  return edge_destinations_;
+}
+
+const std::pmr::vector<Edge::Color>& Graph::get_edge_colors() const {
+  return edge_colors_;
+}
+
+std::size_t Graph::reserved_bytes() const {
+  return sizeof(Graph) + arena_->reserved_bytes();
+}
+
+std::size_t Graph::reused_bytes() const {
+  return arena_->reserved_bytes() - arena_->allocated_bytes();
+}
+
+Graph::MemoryUsage Graph::memory_usage() const {
+  auto usage = MemoryUsage();
+  usage.vertices = get_capacity_bytes(vertex_depths_) +
+                   get_capacity_bytes(vertex_positions_in_depth_) +
+                   get_capacity_bytes(is_vertex_removed_);
+  usage.edges = get_capacity_bytes(edge_sources_) +
+                get_capacity_bytes(edge_destinations_) +
+                get_capacity_bytes(edge_colors_) +
+                get_capacity_bytes(is_edge_removed_);
+  usage.vertex_edge_ids = get_capacity_bytes(vertex_edge_ids_);
+  for (const auto& edge_ids : vertex_edge_ids_) {
+    usage.vertex_edge_ids += edge_ids.spilled_bytes();
+  }
+  usage.depths = get_capacity_bytes(depth_vertex_ids_);
+  for (const auto& vertex_ids : depth_vertex_ids_) {
+    usage.depths += get_capacity_bytes(vertex_ids);
+  }
+  for (const auto& edge_ids : colored_edges_) {
+    usage.colored_edges += get_capacity_bytes(edge_ids);
+  }
+  const auto parts_bytes = usage.total();
+  const auto bytes = reserved_bytes();
+  usage.other = bytes > parts_bytes ? bytes - parts_bytes : 0;
+  return usage;
+}
+
+DepthLayout::DepthLayout(const Graph& graph) {
+  const auto& depth_vertex_ids = graph.depth_vertex_ids_;
+  depth_offsets_.reserve(depth_vertex_ids.size() + 1);
+  depth_offsets_.push_back(0);
+  for (const auto& vertex_ids : depth_vertex_ids) {
+    depth_offsets_.push_back(depth_offsets_.back() + vertex_ids.size());
+  }
+  bool is_layered = true;
+  VertexId layered_vertex_id = 0;
+  for (const auto& vertex_ids : depth_vertex_ids) {
+    for (const auto& vertex_id : vertex_ids) {
+      is_layered = is_layered && vertex_id == layered_vertex_id;
+      layered_vertex_id++;
+    }
+  }
+  if (is_layered)
+    return;
+  layered_vertex_ids_.reserve(depth_offsets_.back());
+  for (const auto& vertex_ids : depth_vertex_ids) {
+    layered_vertex_ids_.insert(layered_vertex_ids_.end(), vertex_ids.begin(),
+                               vertex_ids.end());
+  }
+}
+
+int DepthLayout::depth() const {
+  return static_cast<int>(depth_offsets_.size()) - 2;
+}
+
+VertexIdRange DepthLayout::get_vertices_in_depth(
+    const VertexDepth& depth) const {
+  assert(depth + 1U < depth_offsets_.size() && "Depth is not valid!");
+  if (layered_vertex_ids_.empty())
+    return VertexIdRange::interval(depth_offsets_[depth],
+                                   depth_offsets_[depth + 1]);
+  return VertexIdRange(layered_vertex_ids_.data() + depth_offsets_[depth],
+                       layered_vertex_ids_.data() + depth_offsets_[depth + 1]);
+}
+
+std::size_t DepthLayout::reserved_bytes() const {
+  return get_capacity_bytes(layered_vertex_ids_) +
+         get_capacity_bytes(depth_offsets_);
+}
+
+CsrGraph Graph::freeze(const EdgeDirection& direction,
+                       const std::optional<Edge::Color>& color) const {
+  return CsrGraph(*this, direction, color);
+}
+
+CsrGraph::CsrGraph(const Graph& graph,
+                   const EdgeDirection& direction,
+                   const std::optional<Edge::Color>& color)
+    : depth_layout_(graph) {
+  const auto vertices_count = graph.vertex_ids_count();
+  const auto is_taken = [&direction, &color](const Neighbor& neighbor) {
+    return (direction == EdgeDirection::Both ||
+            direction == neighbor.direction) &&
+           (!color.has_value() || color.value() == neighbor.color);
+  };
+
+  offsets_.reserve(vertices_count + 1);
+  offsets_.push_back(0);
+  for (VertexId vertex_id = 0; vertex_id < vertices_count; vertex_id++) {
+    auto offset = offsets_.back();
+    if (graph.does_vertex_exist(vertex_id)) {
+      for (const auto& neighbor : graph.neighbors(vertex_id)) {
+        offset += is_taken(neighbor);
+      }
+    }
+    offsets_.push_back(offset);
+  }
+
+  adjacent_vertex_ids_.reserve(offsets_.back());
+  for (VertexId vertex_id = 0; vertex_id < vertices_count; vertex_id++) {
+    if (!graph.does_vertex_exist(vertex_id))
+      continue;
+    for (const auto& neighbor : graph.neighbors(vertex_id)) {
+      if (is_taken(neighbor))
+        adjacent_vertex_ids_.push_back(neighbor.vertex_id);
+    }
+  }
+}
+
+bool CsrGraph::does_vertex_exist(const VertexId& id) const {
+  return id < vertices_count();
+}
+
+VertexId CsrGraph::vertices_count() const {
+  return offsets_.size() - 1;
+}
+
+int CsrGraph::depth() const {
+  return depth_layout_.depth();
+}
+
+VertexIdRange CsrGraph::get_adjacent_vertex_ids(
+    const VertexId& vertex_id) const {
+  assert(does_vertex_exist(vertex_id) && "Vertex doesn't exist!");
+  const auto* adjacent_vertex_ids = adjacent_vertex_ids_.data();
+  return VertexIdRange(adjacent_vertex_ids + offsets_[vertex_id],
+                       adjacent_vertex_ids + offsets_[vertex_id + 1]);
+}
+
+VertexIdRange CsrGraph::get_vertices_in_depth(
+    const VertexDepth& depth) const {
+  return depth_layout_.get_vertices_in_depth(depth);
+}
+
+std::size_t CsrGraph::reserved_bytes() const {
+  return sizeof(CsrGraph) + get_capacity_bytes(offsets_) +
+         get_capacity_bytes(adjacent_vertex_ids_) +
+         depth_layout_.reserved_bytes();
+}
+}  // namespace uni_cpp_practice
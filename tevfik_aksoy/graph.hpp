@@ -1,85 +1,527 @@
-#pragma once
-
-#include <string>
-#include <unordered_map>
-#include <vector>
-
-namespace uni_cpp_practice {
-using VertexId = int;
-using EdgeId = int;
-using VertexDepth = int;
-
-struct Vertex {
- public:
-  const VertexId id{};
-  VertexDepth depth = 0;
-
-  explicit Vertex(const VertexId& id) : id(id) {}
-
-  void add_edge_id(const EdgeId& id);
-  const std::vector<EdgeId>& get_edge_ids() const;
-
-  bool has_edge_id(const EdgeId& edge_id, const std::vector<EdgeId>& edge_ids) {
-    for (const auto& edge : edge_ids) {
-      if (edge_id == edge) {
-        return true;
-      }
-    }
-    return false;
-  }
-
- private:
-  std::vector<EdgeId> edge_ids_;
-};
-
-struct Edge {
- public:
-  enum class Color { Gray, Green, Blue, Yellow, Red };
-  const EdgeId id{};
-  const Color color{};
-  const VertexId source{};
-  const VertexId destination{};
-
-  Edge(const VertexId& _source,
-       const VertexId& _destination,
-       const VertexId& _id,
-       const Color& _color)
-      : id(_id), color(_color), source(_source), destination(_destination) {}
-};
-
-std::string color_to_string(const Edge::Color& color);
-
-class Graph {
- public:
-  VertexId insert_vertex();
-  void insert_edge(const VertexId& source_id, const VertexId& destination_id);
-
-  bool does_vertex_exist(const VertexId& id) const;
-
-  bool are_vertices_connected(const VertexId& source,
-                              const VertexId& destination) const;
-  const std::vector<EdgeId>& get_colored_edges(const Edge::Color& color) const;
-  int depth() const;
-  std::vector<VertexId> get_adjacent_vertex_ids(
-      const VertexId& vertex_id) const;
-  const std::vector<Vertex>& get_vertices() const;
-  const std::vector<Edge>& get_edges() const;
-  const std::vector<VertexId>& get_vertices_in_depth(
-      const VertexDepth& depth) const;
-  const Vertex& get_vertex(const VertexId& id) const;
-  const Edge& get_edge(const EdgeId& id) const;
-
- private:
-  std::vector<Edge> edges_;
-  std::vector<Vertex> vertices_;
-  std::vector<std::vector<VertexId>> depth_map_;
-  std::unordered_map<Edge::Color, std::vector<EdgeId>> colored_edges_map_;
-  VertexId vertex_id_counter_ = 0;
-  EdgeId edge_id_counter_ = 0;
-
-  Edge::Color calculate_color_for_edge(const Vertex& source,
-                                       const Vertex& destination) const;
-  VertexId get_new_vertex_id() { return vertex_id_counter_++; }
-  EdgeId get_new_edge_id() { return edge_id_counter_++; }
-};
-}  // namespace uni_cpp_practice
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <vector>
+#include "graph_arena.hpp"
+
+namespace uni_cpp_practice {
+// Ids are 32-bit by default, which is enough for graphs with less than 2^32
+// vertices and edges. Define UNI_CPP_PRACTICE_64_BIT_IDS for bigger ones.
+// Offsets into adjacency arrays, which hold an entry per edge end, are
+// std::size_t either way.
+#ifdef UNI_CPP_PRACTICE_64_BIT_IDS
+using VertexId = std::uint64_t;
+using EdgeId = std::uint64_t;
+using VertexDepth = std::uint32_t;
+#else
+using VertexId = std::uint32_t;
+using EdgeId = std::uint32_t;
+using VertexDepth = std::uint16_t;
+#endif
+
+// Vertex and Edge are plain value records assembled from the columns of a
+// Graph, they are not what the graph stores.
+struct Vertex {
+ public:
+  VertexId id{};
+  VertexDepth depth = 0;
+
+  Vertex(const VertexId& _id, const VertexDepth& _depth)
+      : id(_id), depth(_depth) {}
+};
+
+struct Edge {
+ public:
+  enum class Color : std::uint8_t { Gray, Green, Blue, Yellow, Red };
+  static constexpr std::size_t COLORS_COUNT = 5;
+  static constexpr std::array<Color, COLORS_COUNT> COLORS = {
+      Color::Gray, Color::Green, Color::Blue, Color::Yellow, Color::Red};
+
+  EdgeId id{};
+  Color color{};
+  VertexId source{};
+  VertexId destination{};
+
+  Edge(const VertexId& _source,
+       const VertexId& _destination,
+       const EdgeId& _id,
+       const Color& _color)
+      : id(_id), color(_color), source(_source), destination(_destination) {}
+};
+
+std::string color_to_string(const Edge::Color& color);
+
+// Index of `color` in arrays indexed by color, [0, Edge::COLORS_COUNT).
+constexpr std::size_t get_color_index(const Edge::Color& color) {
+  return static_cast<std::size_t>(color);
+}
+
+// Edge ids of one vertex. Short lists, which most vertices of a generated
+// graph have, are stored in place without any allocation. Longer lists spill
+// to the memory resource passed to reserve() and push_back(): the resource
+// owns that memory and has to outlive the list.
+class EdgeIdList {
+ public:
+  static constexpr EdgeId INLINE_CAPACITY = 24 / sizeof(EdgeId);
+
+  EdgeIdList() = default;
+  EdgeIdList(EdgeIdList&& other) noexcept;
+  EdgeIdList& operator=(EdgeIdList&& other) noexcept;
+  EdgeIdList(const EdgeIdList&) = delete;
+  EdgeIdList& operator=(const EdgeIdList&) = delete;
+
+  void reserve(EdgeId capacity, std::pmr::memory_resource& resource);
+  void push_back(const EdgeId& id, std::pmr::memory_resource& resource) {
+    if (size_ == capacity_)
+      reserve(2 * capacity_, resource);
+    data()[size_++] = id;
+  }
+  // Inserts `id` in front of the id at `index`, at the end if `index` is
+  // size().
+  void insert(EdgeId index,
+              const EdgeId& id,
+              std::pmr::memory_resource& resource);
+  // Removes the first occurrence of `id`, keeping the order of the others.
+  void erase(const EdgeId& id);
+
+  const EdgeId* begin() const { return data(); }
+  const EdgeId* end() const { return data() + size_; }
+  const EdgeId& operator[](EdgeId index) const { return data()[index]; }
+  EdgeId size() const { return size_; }
+  EdgeId capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+  // Bytes taken from the memory resource, 0 while the ids are in place.
+  std::size_t spilled_bytes() const {
+    return is_spilled() ? capacity_ * sizeof(EdgeId) : 0;
+  }
+
+ private:
+  EdgeId size_ = 0;
+  EdgeId capacity_ = INLINE_CAPACITY;
+  union {
+    EdgeId inline_ids_[INLINE_CAPACITY];
+    EdgeId* spilled_ids_;
+  };
+
+  bool is_spilled() const { return capacity_ > INLINE_CAPACITY; }
+  EdgeId* data() { return is_spilled() ? spilled_ids_ : inline_ids_; }
+  const EdgeId* data() const {
+    return is_spilled() ? spilled_ids_ : inline_ids_;
+  }
+};
+
+// Unordered pair of vertices connected by an edge.
+struct ConnectionKey {
+ public:
+  struct Hash {
+    std::size_t operator()(const ConnectionKey& key) const;
+  };
+
+  ConnectionKey(const VertexId& first, const VertexId& second);
+
+  bool operator==(const ConnectionKey& other) const {
+    return first_ == other.first_ && second_ == other.second_;
+  }
+
+ private:
+  VertexId first_{};
+  VertexId second_{};
+};
+
+// Read-only view of consecutive vertex ids stored elsewhere, or of the ids
+// [first_vertex_id, end_vertex_id) when they are an interval nobody stores.
+class VertexIdRange {
+ public:
+  // Ids are computed for an interval, so they are returned by value.
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = VertexId;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const VertexId*;
+    using reference = VertexId;
+
+    // `position` indexes `vertex_ids`, or is the id if they are nullptr.
+    Iterator(const VertexId* vertex_ids, const VertexId& position)
+        : vertex_ids_(vertex_ids), position_(position) {}
+
+    VertexId operator*() const {
+      return vertex_ids_ == nullptr ? position_ : vertex_ids_[position_];
+    }
+    Iterator& operator++() {
+      position_++;
+      return *this;
+    }
+    bool operator==(const Iterator& other) const {
+      return position_ == other.position_;
+    }
+    bool operator!=(const Iterator& other) const {
+      return position_ != other.position_;
+    }
+
+   private:
+    const VertexId* vertex_ids_ = nullptr;
+    VertexId position_{};
+  };
+
+  VertexIdRange(const VertexId* begin, const VertexId* end)
+      : vertex_ids_(begin), size_(end - begin) {}
+  static VertexIdRange interval(const VertexId& first_vertex_id,
+                                const VertexId& end_vertex_id) {
+    return VertexIdRange(first_vertex_id, end_vertex_id - first_vertex_id);
+  }
+
+  Iterator begin() const { return Iterator(vertex_ids_, first_position()); }
+  Iterator end() const {
+    return Iterator(vertex_ids_, first_position() + size_);
+  }
+  VertexId operator[](std::size_t index) const {
+    return vertex_ids_ == nullptr ? first_vertex_id_ + index
+                                  : vertex_ids_[index];
+  }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  VertexIdRange(const VertexId& first_vertex_id, const VertexId& size)
+      : first_vertex_id_(first_vertex_id), size_(size) {}
+
+  VertexId first_position() const {
+    return vertex_ids_ == nullptr ? first_vertex_id_ : 0;
+  }
+
+  const VertexId* vertex_ids_ = nullptr;
+  VertexId first_vertex_id_{};
+  VertexId size_{};
+};
+
+// Edges of a vertex to follow: the ones the vertex is the source of, the
+// ones it is the destination of, or all of them. Edges of a generated graph
+// point from a vertex to a vertex of the same or a bigger depth.
+enum class EdgeDirection { Both, Out, In };
+
+// Vertex connected to another one by an edge.
+struct Neighbor {
+  VertexId vertex_id{};
+  EdgeId edge_id{};
+  Edge::Color color{};
+  // Out if this vertex is the source of the edge and the other one its
+  // destination, In otherwise. Self loops are Out.
+  EdgeDirection direction = EdgeDirection::Out;
+};
+
+// Neighbors of one vertex of a Graph, computed from its columns while
+// iterating, without copying anything. Stays valid until the graph changes.
+class NeighborRange {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Neighbor;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Neighbor*;
+    using reference = Neighbor;
+
+    Iterator(const EdgeId* edge_id,
+             const VertexId& vertex_id,
+             const VertexId* edge_sources,
+             const VertexId* edge_destinations,
+             const Edge::Color* edge_colors)
+        : edge_id_(edge_id),
+          vertex_id_(vertex_id),
+          edge_sources_(edge_sources),
+          edge_destinations_(edge_destinations),
+          edge_colors_(edge_colors) {}
+
+    Neighbor operator*() const {
+      const auto edge_id = *edge_id_;
+      const auto source = edge_sources_[edge_id];
+      if (source == vertex_id_)
+        return {edge_destinations_[edge_id], edge_id, edge_colors_[edge_id],
+                EdgeDirection::Out};
+      return {source, edge_id, edge_colors_[edge_id], EdgeDirection::In};
+    }
+    Iterator& operator++() {
+      ++edge_id_;
+      return *this;
+    }
+    Iterator operator++(int) {
+      auto iterator = *this;
+      ++edge_id_;
+      return iterator;
+    }
+    bool operator==(const Iterator& other) const {
+      return edge_id_ == other.edge_id_;
+    }
+    bool operator!=(const Iterator& other) const {
+      return edge_id_ != other.edge_id_;
+    }
+
+   private:
+    const EdgeId* edge_id_ = nullptr;
+    VertexId vertex_id_{};
+    const VertexId* edge_sources_ = nullptr;
+    const VertexId* edge_destinations_ = nullptr;
+    const Edge::Color* edge_colors_ = nullptr;
+  };
+
+  NeighborRange(const Iterator& begin, const Iterator& end, EdgeId size)
+      : begin_(begin), end_(end), size_(size) {}
+
+  Iterator begin() const { return begin_; }
+  Iterator end() const { return end_; }
+  EdgeId size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  Iterator begin_;
+  Iterator end_;
+  EdgeId size_ = 0;
+};
+
+class CsrGraph;
+class DepthLayout;
+class GraphBuilder;
+
+// Vertex and edge ids are dense: they are handed out as 0, 1, 2, ... and
+// index the columns of the graph directly, so every lookup by id is O(1).
+// Removing a vertex or an edge leaves a hole until compact() makes the ids
+// dense again.
+class Graph {
+ public:
+  // Bytes held by every part of a graph, including unused capacity.
+  struct MemoryUsage {
+    std::size_t vertices = 0;
+    std::size_t edges = 0;
+    std::size_t vertex_edge_ids = 0;
+    std::size_t depths = 0;
+    std::size_t colored_edges = 0;
+    // The Graph object itself and arena memory none of the parts holds,
+    // like storage left behind by containers that grew.
+    std::size_t other = 0;
+
+    std::size_t total() const {
+      return vertices + edges + vertex_edge_ids + depths + colored_edges +
+             other;
+    }
+  };
+
+  // Old ids indexing their new ones after compact(). Ids of removed
+  // vertices and edges map to REMOVED_VERTEX_ID and REMOVED_EDGE_ID.
+  struct IdMaps {
+    static constexpr VertexId REMOVED_VERTEX_ID =
+        std::numeric_limits<VertexId>::max();
+    static constexpr EdgeId REMOVED_EDGE_ID =
+        std::numeric_limits<EdgeId>::max();
+
+    std::vector<VertexId> new_vertex_ids;
+    std::vector<EdgeId> new_edge_ids;
+  };
+
+  Graph();
+  Graph(Graph&&) = default;
+  // Containers of two graphs never share an arena, so one graph can't take
+  // over the storage of another one by assignment.
+  Graph& operator=(Graph&&) = delete;
+  Graph(const Graph&) = delete;
+  Graph& operator=(const Graph&) = delete;
+
+  // Removes all vertices and edges. The memory of the graph is kept for
+  // the next vertices and edges, see GraphArena::reset(). Doesn't allocate.
+  void clear();
+
+  VertexId insert_vertex();
+  void insert_edge(const VertexId& source_id, const VertexId& destination_id);
+
+  // Removed vertices and edges leave tombstones: their ids aren't reused
+  // and the ids of the others don't change until compact(). Removing a
+  // vertex removes its edges too, vertices it was the parent of keep their
+  // depths.
+  void remove_edge(const EdgeId& id);
+  void remove_vertex(const VertexId& id);
+  // Drops the tombstones and gives the memory they took back. Remaining
+  // vertices and edges get dense ids again, in the order of their old ids,
+  // and the returned maps translate ids kept outside of the graph.
+  IdMaps compact();
+
+  bool does_vertex_exist(const VertexId& id) const;
+  bool does_edge_exist(const EdgeId& id) const;
+
+  // O(log edges of `source`), see neighbors().
+  bool are_vertices_connected(const VertexId& source,
+                              const VertexId& destination) const;
+  const std::pmr::vector<EdgeId>& get_colored_edges(
+      const Edge::Color& color) const;
+  int depth() const;
+  // Neighbors of the vertex ordered by their ids. A vertex with a green
+  // edge is a neighbor of itself.
+  NeighborRange neighbors(const VertexId& vertex_id) const;
+  // Only the neighbors with ids in [first_vertex_id, end_vertex_id), found
+  // by binary search.
+  NeighborRange neighbors(const VertexId& vertex_id,
+                          const VertexId& first_vertex_id,
+                          const VertexId& end_vertex_id) const;
+  std::vector<VertexId> get_adjacent_vertex_ids(
+      const VertexId& vertex_id) const;
+  // Vertices and edges that weren't removed.
+  VertexId vertices_count() const;
+  EdgeId edges_count() const;
+  // Ids handed out so far, removed ones included: every existing vertex id
+  // is less than vertex_ids_count(), every edge id less than
+  // edge_ids_count(). The same as the counts above without tombstones.
+  VertexId vertex_ids_count() const;
+  EdgeId edge_ids_count() const;
+  // Vertices of a depth in the order they got it. GraphBuilder numbers the
+  // vertices of every depth consecutively, so there it is a range of ids.
+  VertexIdRange get_vertices_in_depth(const VertexDepth& depth) const;
+  // Throw if the vertex or the edge doesn't exist.
+  Vertex get_vertex(const VertexId& id) const;
+  Edge get_edge(const EdgeId& id) const;
+  // Only assert that it exists, for callers that already know it does.
+  Vertex get_vertex_unchecked(const VertexId& id) const;
+  Edge get_edge_unchecked(const EdgeId& id) const;
+  const EdgeIdList& get_vertex_edge_ids(const VertexId& id) const;
+
+  // Columns indexed by VertexId and EdgeId, for scans that need only one
+  // attribute of every vertex or edge. They have entries for removed
+  // vertices and edges too.
+  const std::pmr::vector<VertexDepth>& get_vertex_depths() const;
+  const std::pmr::vector<VertexId>& get_edge_sources() const;
+  const std::pmr::vector<VertexId>& get_edge_destinations() const;
+  const std::pmr::vector<Edge::Color>& get_edge_colors() const;
+
+  // Removed vertices are in the snapshot as vertices without edges. See
+  // CsrGraph for `direction` and `color`.
+  CsrGraph freeze(
+      const EdgeDirection& direction = EdgeDirection::Both,
+      const std::optional<Edge::Color>& color = std::nullopt) const;
+
+  // Bytes of memory the graph holds, used or not.
+  std::size_t reserved_bytes() const;
+  // Bytes of reserved_bytes() the graph kept from before it was last
+  // cleared, instead of allocating them again.
+  std::size_t reused_bytes() const;
+  MemoryUsage memory_usage() const;
+
+ private:
+  friend class DepthLayout;
+  friend class GraphBuilder;
+
+  // All the storage of the graph comes from a few big blocks of this arena
+  // and is released at once with the graph, or by compact(). Nothing is
+  // freed before that, the graph only grows. Held by pointer, so the
+  // containers stay valid when the graph is moved. Declared first, as the
+  // containers use it.
+  std::unique_ptr<GraphArena> arena_;
+  std::pmr::vector<VertexDepth> vertex_depths_{arena_.get()};
+  // Index of every vertex within the vertices of its depth.
+  std::pmr::vector<VertexId> vertex_positions_in_depth_{arena_.get()};
+  // Edge ids of every vertex, sorted by the id of the vertex at the other
+  // end, which makes them an index of the adjacent vertices.
+  std::pmr::vector<EdgeIdList> vertex_edge_ids_{arena_.get()};
+  std::pmr::vector<char> is_vertex_removed_{arena_.get()};
+  std::pmr::vector<VertexId> edge_sources_{arena_.get()};
+  std::pmr::vector<VertexId> edge_destinations_{arena_.get()};
+  std::pmr::vector<Edge::Color> edge_colors_{arena_.get()};
+  std::pmr::vector<char> is_edge_removed_{arena_.get()};
+  // Vertices of every depth in the order they got it, a vertex getting a
+  // depth is appended in O(1). Vertices without a depth, never connected by
+  // a gray edge, are in none of them. Snapshots lay them out one depth after
+  // another, see DepthLayout.
+  std::pmr::vector<std::pmr::vector<VertexId>> depth_vertex_ids_{
+      arena_.get()};
+  // Edge ids of every color, indexed by get_color_index().
+  std::array<std::pmr::vector<EdgeId>, Edge::COLORS_COUNT> colored_edges_{
+      {std::pmr::vector<EdgeId>(arena_.get()),
+       std::pmr::vector<EdgeId>(arena_.get()),
+       std::pmr::vector<EdgeId>(arena_.get()),
+       std::pmr::vector<EdgeId>(arena_.get()),
+       std::pmr::vector<EdgeId>(arena_.get())}};
+  VertexId vertex_id_counter_ = 0;
+  EdgeId edge_id_counter_ = 0;
+  VertexId removed_vertices_count_ = 0;
+  EdgeId removed_edges_count_ = 0;
+
+  // Empties every container, before the memory of the arena is reused.
+  void release_containers();
+  // Same as clear(), but the arena gets a block of at least `arena_bytes`,
+  // see GraphArena::reset().
+  void clear(std::size_t arena_bytes);
+  bool is_vertex_layered(const VertexId& id) const;
+  VertexId get_adjacent_vertex_id(const EdgeId& edge_id,
+                                  const VertexId& vertex_id) const {
+    return edge_sources_[edge_id] == vertex_id ? edge_destinations_[edge_id]
+                                               : edge_sources_[edge_id];
+  }
+  // First edge of the vertex to a vertex with an id not less than
+  // `adjacent_vertex_id`.
+  const EdgeId* find_edge_id(const VertexId& vertex_id,
+                             const VertexId& adjacent_vertex_id) const;
+  Edge::Color calculate_color_for_edge(const VertexId& source_id,
+                                       const VertexId& destination_id) const;
+  // Appends a vertex to the vertices of `depth`.
+  void insert_layered_vertex(const VertexId& vertex_id,
+                             const VertexDepth& depth);
+  VertexId get_new_vertex_id() { return vertex_id_counter_++; }
+  EdgeId get_new_edge_id() { return edge_id_counter_++; }
+};
+
+// Vertices of a Graph ordered by depth, the vertices of one depth after
+// the other, for the read-only snapshots of it.
+class DepthLayout {
+ public:
+  explicit DepthLayout(const Graph& graph);
+
+  int depth() const;
+  VertexIdRange get_vertices_in_depth(const VertexDepth& depth) const;
+
+  // Bytes of memory the layout holds besides the object itself, used or
+  // not.
+  std::size_t reserved_bytes() const;
+
+ private:
+  // Depth `d` is [depth_offsets_[d], depth_offsets_[d + 1]) of
+  // layered_vertex_ids_. Left empty when the vertices are numbered depth
+  // after depth, like GraphBuilder numbers them: the offsets are the ids
+  // then.
+  std::vector<VertexId> layered_vertex_ids_;
+  std::vector<VertexId> depth_offsets_;
+};
+
+// Immutable snapshot of a generated Graph in compressed sparse row layout.
+// Adjacent vertex ids of every vertex are stored contiguously, one offset
+// per vertex says where they start. Only the edges of one direction, and of
+// one color if it is given, are taken: a snapshot per color is how the edges
+// of a color are walked without filtering the rest.
+class CsrGraph {
+ public:
+  explicit CsrGraph(
+      const Graph& graph,
+      const EdgeDirection& direction = EdgeDirection::Both,
+      const std::optional<Edge::Color>& color = std::nullopt);
+
+  bool does_vertex_exist(const VertexId& id) const;
+  VertexId vertices_count() const;
+  int depth() const;
+  VertexIdRange get_adjacent_vertex_ids(const VertexId& vertex_id) const;
+  VertexIdRange get_vertices_in_depth(const VertexDepth& depth) const;
+
+  // Bytes of memory the snapshot holds, used or not.
+  std::size_t reserved_bytes() const;
+
+ private:
+  // Adjacent vertex ids of vertex `i` are [offsets_[i], offsets_[i + 1]) of
+  // adjacent_vertex_ids_.
+  std::vector<std::size_t> offsets_;
+  std::vector<VertexId> adjacent_vertex_ids_;
+  DepthLayout depth_layout_;
+};
+}  // namespace uni_cpp_practice
@@ -0,0 +1,66 @@
+#include "graph_arena.hpp"
+
+namespace uni_cpp_practice {
+
+void* GraphArena::HeapResource::do_allocate(std::size_t bytes,
+                                            std::size_t alignment) {
+  auto* const pointer =
+      std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  allocated_bytes_ += bytes;
+  return pointer;
+}
+
+void GraphArena::HeapResource::do_deallocate(void* pointer,
+                                             std::size_t bytes,
+                                             std::size_t alignment) {
+  std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+  allocated_bytes_ -= bytes;
+}
+
+GraphArena::GraphArena() {
+  resource_.emplace(&heap_);
+}
+
+void GraphArena::reset(std::size_t bytes) {
+  resource_.reset();
+  allocated_block_size_ = 0;
+  if (bytes > initial_block_size_) {
+    // The old block goes first, so both are never held at once.
+    initial_block_.reset();
+    initial_block_.reset(new std::byte[bytes]);
+    initial_block_size_ = bytes;
+    allocated_block_size_ = bytes;
+  }
+  if (initial_block_ != nullptr) {
+    resource_.emplace(initial_block_.get(), initial_block_size_, &heap_);
+  } else {
+    resource_.emplace(&heap_);
+  }
+}
+
+void GraphArena::release() {
+  resource_.reset();
+  initial_block_.reset();
+  initial_block_size_ = 0;
+  allocated_block_size_ = 0;
+  resource_.emplace(&heap_);
+}
+
+std::size_t GraphArena::reserved_bytes() const {
+  return initial_block_size_ + heap_.allocated_bytes();
+}
+
+std::size_t GraphArena::allocated_bytes() const {
+  return allocated_block_size_ + heap_.allocated_bytes();
+}
+
+void* GraphArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+  return resource_->allocate(bytes, alignment);
+}
+
+void GraphArena::do_deallocate(void* pointer,
+                               std::size_t bytes,
+                               std::size_t alignment) {
+  resource_->deallocate(pointer, bytes, alignment);
+}
+}  // namespace uni_cpp_practice
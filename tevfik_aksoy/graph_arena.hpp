@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace uni_cpp_practice {
+// Monotonic arena backing all the storage of one Graph: memory is handed out
+// from a block, and from the heap once the block is full, and is only given
+// back all at once.
+//
+// reset() makes the arena reusable for another graph. The block is kept, so
+// a graph that fits into it doesn't touch the heap at all.
+class GraphArena : public std::pmr::memory_resource {
+ public:
+  GraphArena();
+  GraphArena(const GraphArena&) = delete;
+  GraphArena& operator=(const GraphArena&) = delete;
+
+  // Nothing allocated from the arena may be used after it is reset or
+  // released. Memory taken from the heap beyond the block is given back. A
+  // block smaller than `bytes` is replaced by one of exactly `bytes`, for
+  // callers that know how much they are going to take, a bigger one is
+  // kept.
+  void reset(std::size_t bytes = 0);
+  // Gives all the memory of the arena back, the next round starts empty.
+  void release();
+
+  // Bytes the arena currently holds, used or not.
+  std::size_t reserved_bytes() const;
+  // Bytes of reserved_bytes() taken from the heap since the arena was last
+  // reset, a block reset() had to allocate included. The rest was kept from
+  // the rounds before.
+  std::size_t allocated_bytes() const;
+
+ private:
+  // Heap memory resource that counts the bytes it currently has out.
+  class HeapResource : public std::pmr::memory_resource {
+   public:
+    std::size_t allocated_bytes() const { return allocated_bytes_; }
+
+   private:
+    std::size_t allocated_bytes_ = 0;
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pointer,
+                       std::size_t bytes,
+                       std::size_t alignment) override;
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+  };
+
+  std::unique_ptr<std::byte[]> initial_block_;
+  std::size_t initial_block_size_ = 0;
+  // Size of the block if reset() allocated it, 0 if it was kept.
+  std::size_t allocated_block_size_ = 0;
+  HeapResource heap_;
+  std::optional<std::pmr::monotonic_buffer_resource> resource_;
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void* pointer,
+                     std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+}  // namespace uni_cpp_practice
@@ -0,0 +1,418 @@
+#include "graph_builder.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+
+namespace {
+using uni_cpp_practice::Edge;
+using uni_cpp_practice::EdgeId;
+using uni_cpp_practice::VertexDepth;
+using uni_cpp_practice::VertexId;
+
+constexpr EdgeId MIN_ITEMS_PER_THREAD = 4096;
+
+int get_chunks_count(int threads_count, EdgeId items_count) {
+  return std::max<EdgeId>(
+      1, std::min<EdgeId>(threads_count, items_count / MIN_ITEMS_PER_THREAD));
+}
+
+// Calls `callback(begin, end)` for `chunks_count` consecutive chunks of
+// [0, size), each chunk on its own thread.
+template <typename Callback>
+void run_in_parallel(int chunks_count,
+                     EdgeId size,
+                     const Callback& callback) {
+  if (chunks_count <= 1) {
+    callback(0, size);
+    return;
+  }
+  const auto chunk_size = (size + chunks_count - 1) / chunks_count;
+  auto threads = std::vector<std::thread>();
+  threads.reserve(chunks_count);
+  for (EdgeId begin = 0; begin < size; begin += chunk_size) {
+    threads.emplace_back(std::cref(callback), begin,
+                         std::min(size, begin + chunk_size));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// Upper bound of the bytes `count` values of T take from the arena of a
+// Graph, padding for their alignment included.
+template <typename T>
+std::size_t get_arena_bytes(std::size_t count) {
+  return count > 0 ? count * sizeof(T) + alignof(T) - 1 : 0;
+}
+
+// Same rules as Graph::calculate_color_for_edge() for an edge that is not
+// gray, given the final depths and positions within the depth.
+std::optional<Edge::Color> calculate_color_for_edge(
+    const VertexId& source,
+    const VertexId& destination,
+    const std::vector<VertexDepth>& depths,
+    const std::vector<VertexId>& positions_in_depth) {
+  if (source == destination)
+    return Edge::Color::Green;
+  const auto source_depth = depths[source];
+  const auto destination_depth = depths[destination];
+  if (source_depth == destination_depth &&
+      (positions_in_depth[source] + 1 == positions_in_depth[destination] ||
+       positions_in_depth[destination] + 1 == positions_in_depth[source]))
+    return Edge::Color::Blue;
+  if (source_depth == destination_depth - 1)
+    return Edge::Color::Yellow;
+  if (source_depth == destination_depth - 2)
+    return Edge::Color::Red;
+  return std::nullopt;
+}
+}  // namespace
+
+namespace uni_cpp_practice {
+
+GraphBuilder::GraphBuilder(int threads_count)
+    : threads_count_(threads_count > 0
+                         ? threads_count
+                         : std::max(1u, std::thread::hardware_concurrency())) {}
+
+GraphBuilder::GraphBuilder(const Graph& graph, int threads_count)
+    : GraphBuilder(threads_count) {
+  assert(graph.vertices_count() == graph.vertex_ids_count() &&
+         "Graph has removed vertices!");
+  const auto vertices_count = graph.vertices_count();
+  vertices_count_ = vertices_count;
+  auto& initial_graph = initial_graph_;
+  initial_graph.depths.assign(graph.vertex_depths_.begin(),
+                              graph.vertex_depths_.end());
+  initial_graph.positions_in_depth.assign(
+      graph.vertex_positions_in_depth_.begin(),
+      graph.vertex_positions_in_depth_.end());
+  initial_graph.is_layered.resize(vertices_count);
+  initial_graph.has_edges.resize(vertices_count);
+  for (VertexId vertex_id = 0; vertex_id < vertices_count; vertex_id++) {
+    initial_graph.is_layered[vertex_id] = graph.is_vertex_layered(vertex_id);
+    initial_graph.has_edges[vertex_id] =
+        !graph.vertex_edge_ids_[vertex_id].empty();
+  }
+  for (const auto& vertex_ids : graph.depth_vertex_ids_) {
+    initial_graph.depth_sizes.push_back(vertex_ids.size());
+  }
+
+  auto edges = std::vector<EdgeRecord>();
+  edges.reserve(graph.edges_count());
+  for (EdgeId edge_id = 0; edge_id < graph.edge_ids_count(); edge_id++) {
+    if (!graph.does_edge_exist(edge_id))
+      continue;
+    edges.emplace_back(graph.edge_sources_[edge_id],
+                       graph.edge_destinations_[edge_id],
+                       graph.edge_colors_[edge_id]);
+  }
+  initial_graph.edges_count = edges.size();
+  insert_edges(std::move(edges));
+}
+
+VertexId GraphBuilder::insert_vertex() {
+  return insert_vertices(1);
+}
+
+VertexId GraphBuilder::insert_vertices(VertexId count) {
+  return vertices_count_.fetch_add(count);
+}
+
+void GraphBuilder::insert_edges(std::vector<EdgeRecord> edges) {
+  if (edges.empty()) {
+    return;
+  }
+  const std::lock_guard lock(edge_chunks_mutex_);
+  edge_chunks_.push_back(std::move(edges));
+}
+
+std::vector<char> GraphBuilder::find_duplicate_edges(
+    const std::vector<EdgeRecord>& edges,
+    VertexId vertices_count) const {
+  const EdgeId edges_count = edges.size();
+  const auto buckets_count = get_chunks_count(threads_count_, edges_count);
+
+  // Counting sort of edge indices by a hash of the vertex pair: repeated
+  // pairs land in the same bucket and keep their insertion order.
+  std::vector<int> edge_buckets(edges_count);
+  std::atomic<bool> has_invalid_vertex = false;
+  run_in_parallel(buckets_count, edges_count, [&](EdgeId begin, EdgeId end) {
+    for (auto i = begin; i < end; i++) {
+      const auto& edge = edges[i];
+      if (edge.source >= vertices_count ||
+          edge.destination >= vertices_count) {
+        has_invalid_vertex = true;
+        return;
+      }
+      edge_buckets[i] = ConnectionKey::Hash()(ConnectionKey(
+                            edge.source, edge.destination)) %
+                        buckets_count;
+    }
+  });
+  if (has_invalid_vertex)
+    throw std::runtime_error("Vertex doesn't exist!");
+
+  std::vector<EdgeId> bucket_offsets(buckets_count + 1, 0);
+  for (const auto& bucket : edge_buckets) {
+    bucket_offsets[bucket + 1]++;
+  }
+  std::partial_sum(bucket_offsets.begin(), bucket_offsets.end(),
+                   bucket_offsets.begin());
+  std::vector<EdgeId> sorted_edge_indices(edges_count);
+  auto bucket_ends = bucket_offsets;
+  for (EdgeId i = 0; i < edges_count; i++) {
+    sorted_edge_indices[bucket_ends[edge_buckets[i]]++] = i;
+  }
+
+  std::vector<char> is_duplicate(edges_count, false);
+  run_in_parallel(buckets_count, buckets_count, [&](EdgeId begin, EdgeId end) {
+    for (auto bucket = begin; bucket < end; bucket++) {
+      std::unordered_set<ConnectionKey, ConnectionKey::Hash> connections;
+      connections.reserve(bucket_offsets[bucket + 1] - bucket_offsets[bucket]);
+      for (auto i = bucket_offsets[bucket]; i < bucket_offsets[bucket + 1];
+           i++) {
+        const auto& edge = edges[sorted_edge_indices[i]];
+        if (!connections.emplace(edge.source, edge.destination).second) {
+          is_duplicate[sorted_edge_indices[i]] = true;
+        }
+      }
+    }
+  });
+  return is_duplicate;
+}
+
+Graph GraphBuilder::build() const {
+  Graph graph;
+  build(graph);
+  return graph;
+}
+
+void GraphBuilder::build(Graph& graph) const {
+  const VertexId vertices_count = vertices_count_;
+  const auto edges = [this]() {
+    const std::lock_guard lock(edge_chunks_mutex_);
+    auto edges = std::vector<EdgeRecord>();
+    EdgeId edges_count = 0;
+    for (const auto& edge_chunk : edge_chunks_) {
+      edges_count += edge_chunk.size();
+    }
+    edges.reserve(edges_count);
+    for (const auto& edge_chunk : edge_chunks_) {
+      edges.insert(edges.end(), edge_chunk.begin(), edge_chunk.end());
+    }
+    return edges;
+  }();
+  const auto is_duplicate = find_duplicate_edges(edges, vertices_count);
+
+  // Whether an edge is gray depends on the edges inserted before it, so
+  // gray edges and the depths they assign are resolved in insertion order.
+  // The colors of all other edges depend on the final depths only.
+  // A builder started from a graph goes on from its depths.
+  const auto& initial_graph = initial_graph_;
+  const VertexId initial_vertices_count = initial_graph.depths.size();
+  std::vector<EdgeId> edge_record_indices;
+  std::vector<char> is_gray;
+  std::vector<char> has_edges(vertices_count, false);
+  std::vector<char> is_layered(vertices_count, false);
+  std::vector<VertexDepth> depths(vertices_count, 0);
+  std::vector<VertexId> positions_in_depth(vertices_count, 0);
+  std::vector<VertexId> depth_sizes = initial_graph.depth_sizes;
+  std::copy(initial_graph.has_edges.begin(), initial_graph.has_edges.end(),
+            has_edges.begin());
+  std::copy(initial_graph.is_layered.begin(), initial_graph.is_layered.end(),
+            is_layered.begin());
+  std::copy(initial_graph.depths.begin(), initial_graph.depths.end(),
+            depths.begin());
+  std::copy(initial_graph.positions_in_depth.begin(),
+            initial_graph.positions_in_depth.end(),
+            positions_in_depth.begin());
+  if (initial_vertices_count == 0 && vertices_count > 0) {
+    is_layered[0] = true;
+    depth_sizes.push_back(1);
+  }
+  for (EdgeId i = 0; i < edges.size(); i++) {
+    if (is_duplicate[i]) {
+      continue;
+    }
+    edge_record_indices.push_back(i);
+    // Edges of the initial graph keep their colors and are already
+    // accounted for in the depths.
+    if (i < initial_graph.edges_count) {
+      is_gray.push_back(edges[i].color == Edge::Color::Gray);
+      continue;
+    }
+    const auto source = edges[i].source;
+    const auto destination = edges[i].destination;
+    is_gray.push_back(!has_edges[source] || !has_edges[destination]);
+    // Same as in Graph::insert_edge(), only a new vertex gets a depth.
+    const auto is_new_layered_vertex = is_gray.back() &&
+                                       !has_edges[destination] &&
+                                       !is_layered[destination];
+    has_edges[source] = true;
+    has_edges[destination] = true;
+    if (is_new_layered_vertex) {
+      const VertexDepth depth = depths[source] + 1;
+      if (depth_sizes.size() == depth) {
+        depth_sizes.push_back(0);
+      }
+      depths[destination] = depth;
+      positions_in_depth[destination] = depth_sizes[depth]++;
+      is_layered[destination] = true;
+    }
+  }
+
+  // Colors are resolved before `graph` is touched, so that a failure leaves
+  // it as it was.
+  const EdgeId edges_count = edge_record_indices.size();
+  auto colors = std::vector<Edge::Color>(edges_count);
+  std::atomic<bool> has_uncolored_edge = false;
+  std::atomic<bool> has_mismatching_color = false;
+  run_in_parallel(
+      get_chunks_count(threads_count_, edges_count), edges_count,
+      [&](EdgeId begin, EdgeId end) {
+        for (auto i = begin; i < end; i++) {
+          const auto& edge = edges[edge_record_indices[i]];
+          if (edge_record_indices[i] < initial_graph.edges_count) {
+            colors[i] = edge.color.value();
+            continue;
+          }
+          const auto color =
+              is_gray[i] ? Edge::Color::Gray
+                         : calculate_color_for_edge(edge.source,
+                                                    edge.destination, depths,
+                                                    positions_in_depth);
+          if (!color.has_value()) {
+            has_uncolored_edge = true;
+            return;
+          }
+          if (edge.color.has_value() && edge.color.value() != color.value()) {
+            has_mismatching_color = true;
+            return;
+          }
+          colors[i] = color.value();
+        }
+      });
+  if (has_uncolored_edge)
+    throw std::runtime_error("Failed to calculate edge color");
+  if (has_mismatching_color)
+    throw std::runtime_error("Edge color doesn't match its vertices!");
+
+  std::vector<EdgeId> degrees(vertices_count, 0);
+  auto colored_edges_counts = std::array<EdgeId, Edge::COLORS_COUNT>();
+  for (EdgeId i = 0; i < edges_count; i++) {
+    const auto& edge = edges[edge_record_indices[i]];
+    degrees[edge.source]++;
+    if (colors[i] != Edge::Color::Green)
+      degrees[edge.destination]++;
+    colored_edges_counts[get_color_index(colors[i])]++;
+  }
+
+  // Every container of the graph is sized exactly below, so the arena gets
+  // a single block that fits them all.
+  auto arena_bytes = get_arena_bytes<VertexDepth>(vertices_count) +
+                     get_arena_bytes<VertexId>(vertices_count) +
+                     get_arena_bytes<EdgeIdList>(vertices_count) +
+                     get_arena_bytes<char>(vertices_count) +
+                     2 * get_arena_bytes<VertexId>(edges_count) +
+                     get_arena_bytes<Edge::Color>(edges_count) +
+                     get_arena_bytes<char>(edges_count) +
+                     get_arena_bytes<std::pmr::vector<VertexId>>(
+                         depth_sizes.size());
+  for (const auto& depth_size : depth_sizes) {
+    arena_bytes += get_arena_bytes<VertexId>(depth_size);
+  }
+  for (const auto& colored_edges_count : colored_edges_counts) {
+    arena_bytes += get_arena_bytes<EdgeId>(colored_edges_count);
+  }
+  for (const auto& degree : degrees) {
+    if (degree > EdgeIdList::INLINE_CAPACITY)
+      arena_bytes += get_arena_bytes<EdgeId>(degree);
+  }
+
+  graph.clear(arena_bytes);
+  graph.vertex_id_counter_ = vertices_count;
+
+  // Vertices are renumbered so that every depth is a range of consecutive
+  // ids, ordered by position within the depth. Vertices without a depth get
+  // the ids after all of them. Renumbering a graph built this way doesn't
+  // change any id.
+  std::vector<VertexId> depth_offsets(depth_sizes.size() + 1, 0);
+  std::partial_sum(depth_sizes.begin(), depth_sizes.end(),
+                   depth_offsets.begin() + 1);
+  std::vector<VertexId> new_vertex_ids(vertices_count);
+  auto next_vertex_id_without_depth = depth_offsets.back();
+  for (VertexId vertex_id = 0; vertex_id < vertices_count; vertex_id++) {
+    new_vertex_ids[vertex_id] =
+        is_layered[vertex_id]
+            ? depth_offsets[depths[vertex_id]] + positions_in_depth[vertex_id]
+            : next_vertex_id_without_depth++;
+  }
+  graph.depth_vertex_ids_.resize(depth_sizes.size());
+  for (std::size_t depth = 0; depth < depth_sizes.size(); depth++) {
+    auto& vertex_ids = graph.depth_vertex_ids_[depth];
+    vertex_ids.resize(depth_sizes[depth]);
+    std::iota(vertex_ids.begin(), vertex_ids.end(), depth_offsets[depth]);
+  }
+  graph.vertex_depths_.resize(vertices_count);
+  graph.vertex_positions_in_depth_.resize(vertices_count);
+  graph.vertex_edge_ids_.resize(vertices_count);
+  graph.is_vertex_removed_.assign(vertices_count, false);
+  for (VertexId vertex_id = 0; vertex_id < vertices_count; vertex_id++) {
+    const auto new_vertex_id = new_vertex_ids[vertex_id];
+    graph.vertex_depths_[new_vertex_id] = depths[vertex_id];
+    graph.vertex_positions_in_depth_[new_vertex_id] =
+        positions_in_depth[vertex_id];
+    graph.vertex_edge_ids_[new_vertex_id].reserve(degrees[vertex_id],
+                                                  *graph.arena_);
+  }
+
+  auto& sources = graph.edge_sources_;
+  auto& destinations = graph.edge_destinations_;
+  sources.reserve(edges_count);
+  destinations.reserve(edges_count);
+  for (const auto& i : edge_record_indices) {
+    sources.push_back(new_vertex_ids[edges[i].source]);
+    destinations.push_back(new_vertex_ids[edges[i].destination]);
+  }
+  graph.edge_colors_.assign(colors.begin(), colors.end());
+  graph.is_edge_removed_.assign(edges_count, false);
+
+  for (std::size_t i = 0; i < Edge::COLORS_COUNT; i++) {
+    graph.colored_edges_[i].reserve(colored_edges_counts[i]);
+  }
+  // Edge ids of every vertex are sorted by the vertex at the other end
+  // without sorting: they are grouped by one end first, and every group
+  // hands its edges to their other ends in the order of the vertex ids.
+  std::vector<EdgeId> grouped_edge_id_offsets(vertices_count + 1, 0);
+  for (VertexId vertex_id = 0; vertex_id < vertices_count; vertex_id++) {
+    grouped_edge_id_offsets[new_vertex_ids[vertex_id] + 1] = degrees[vertex_id];
+  }
+  std::partial_sum(grouped_edge_id_offsets.begin(),
+                   grouped_edge_id_offsets.end(),
+                   grouped_edge_id_offsets.begin());
+  std::vector<EdgeId> grouped_edge_ids(grouped_edge_id_offsets.back());
+  auto group_ends = grouped_edge_id_offsets;
+  for (EdgeId edge_id = 0; edge_id < edges_count; edge_id++) {
+    grouped_edge_ids[group_ends[sources[edge_id]]++] = edge_id;
+    if (colors[edge_id] != Edge::Color::Green)
+      grouped_edge_ids[group_ends[destinations[edge_id]]++] = edge_id;
+    graph.colored_edges_[get_color_index(colors[edge_id])].push_back(edge_id);
+  }
+  for (VertexId vertex_id = 0; vertex_id < vertices_count; vertex_id++) {
+    for (auto i = grouped_edge_id_offsets[vertex_id];
+         i < grouped_edge_id_offsets[vertex_id + 1]; i++) {
+      const auto edge_id = grouped_edge_ids[i];
+      graph.vertex_edge_ids_[graph.get_adjacent_vertex_id(edge_id, vertex_id)]
+          .push_back(edge_id, *graph.arena_);
+    }
+  }
+  graph.edge_id_counter_ = edges_count;
+}
+}  // namespace uni_cpp_practice
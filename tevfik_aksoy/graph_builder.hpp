@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "graph.hpp"
+
+namespace uni_cpp_practice {
+// Builds a Graph from batches of edges in one pass. The result is the same
+// graph Graph::insert_edge would produce if the edges were inserted one by
+// one in the order they were added, with repeated vertex pairs dropped, up to
+// vertex ids: the built graph numbers the vertices of every depth
+// consecutively, see build(). A builder started from a graph goes on from
+// its depths and colors, as if the edges were inserted into that graph.
+//
+// insert_vertex(), insert_vertices() and insert_edges() may be called from
+// several threads at once: vertex ids are reserved atomically and every call
+// of insert_edges() hands over a whole chunk of edges, so threads only
+// synchronize once per chunk.
+class GraphBuilder {
+ public:
+  struct EdgeRecord {
+    EdgeRecord(const VertexId& _source,
+               const VertexId& _destination,
+               const std::optional<Edge::Color>& _color = std::nullopt)
+        : source(_source), destination(_destination), color(_color) {}
+
+    VertexId source{};
+    VertexId destination{};
+    // If set, it is validated against the color calculated from the depths
+    // of the vertices.
+    std::optional<Edge::Color> color;
+  };
+
+  explicit GraphBuilder(int threads_count = 0);
+  // Starts with the vertices and edges of `graph`, under their ids in it.
+  // Its depths and edge colors are taken as they are, so edges may have
+  // been removed from it. Vertices may not, compact() it first then.
+  explicit GraphBuilder(const Graph& graph, int threads_count = 0);
+
+  VertexId insert_vertex();
+  // Returns the id of the first of `count` consecutive new vertices.
+  VertexId insert_vertices(VertexId count);
+  // Edges of one chunk keep their order, chunks are ordered by the time they
+  // were inserted.
+  void insert_edges(std::vector<EdgeRecord> edges);
+
+  // Builds a Graph of everything inserted so far. The builder keeps its
+  // contents, so more edges can be inserted and the graph built again.
+  // Vertex 0 keeps its id, the others are renumbered by depth and by the
+  // order they got it, so the ids the builder handed out are not the ids of
+  // the built graph unless it was built from a graph built this way.
+  Graph build() const;
+  // Same, but clears and reuses `graph` instead of creating a new one.
+  void build(Graph& graph) const;
+
+ private:
+  // Depths of the vertices of the graph the builder was started from, and
+  // the number of its edges, which are the first edge records.
+  struct InitialGraph {
+    std::vector<VertexDepth> depths;
+    std::vector<VertexId> positions_in_depth;
+    std::vector<char> is_layered;
+    std::vector<char> has_edges;
+    std::vector<VertexId> depth_sizes;
+    EdgeId edges_count = 0;
+  };
+
+  const int threads_count_;
+  InitialGraph initial_graph_;
+  std::atomic<VertexId> vertices_count_ = 0;
+  std::list<std::vector<EdgeRecord>> edge_chunks_;
+  mutable std::mutex edge_chunks_mutex_;
+
+  std::vector<char> find_duplicate_edges(const std::vector<EdgeRecord>& edges,
+                                         VertexId vertices_count) const;
+};
+}  // namespace uni_cpp_practice
@@ -1,215 +1,449 @@
-#include "graph_generator.hpp"
-#include <array>
-#include <atomic>
-#include <functional>
-#include <iostream>
-#include <list>
-#include <random>
-#include <thread>
-
-using VertexId = uni_cpp_practice::VertexId;
-using Graph = uni_cpp_practice::Graph;
-
-constexpr int MAX_THREADS_COUNT = 4;
-
-namespace {
-constexpr float GREEN_EDGE_PROBABILITY = 0.1;
-constexpr float BLUE_EDGE_PROBABILITY = 0.25;
-constexpr float RED_EDGE_PROBABILITY = 0.33;
-
-float get_random_probability() {
-  std::random_device rd;
-  std::mt19937 mt(rd());
-  std::uniform_real_distribution<float> probability(0.0, 1);
-  return probability(mt);
-}
-
-VertexId get_random_vertex_id(const std::vector<VertexId>& vertices) {
-  std::random_device rd;
-  std::mt19937 mt(rd());
-  std::uniform_int_distribution<int> random_vertex_distribution(
-      0, vertices.size() - 1);
-  return vertices[random_vertex_distribution(mt)];
-}
-
-std::vector<VertexId> filter_connected_vertices(
-    const VertexId& vertex_id,
-    const std::vector<VertexId>& next_vertices,
-    const Graph& graph,
-    std::mutex& mutex) {
-  std::vector<VertexId> filtered_vertices;
-  for (const auto& next_vertex_id : next_vertices) {
-    const auto is_connected = [&graph, &mutex, vertex_id, &next_vertex_id]() {
-      const std::lock_guard lock(mutex);
-      return graph.are_vertices_connected(vertex_id, next_vertex_id);
-    }();
-    if (!is_connected) {
-      filtered_vertices.push_back(next_vertex_id);
-    }
-  }
-  return filtered_vertices;
-}
-}  // namespace
-
-namespace uni_cpp_practice {
-
-void GraphGenerator::generate_gray_branch(Graph& graph,
-                                          std::mutex& mutex,
-                                          const VertexId& source_vertex_id,
-                                          VertexDepth depth) const {
-  const auto new_vertex_id = [&graph, &mutex, &source_vertex_id]() {
-    const std::lock_guard lock(mutex);
-    const auto& new_vertex_id = graph.insert_vertex();
-    graph.insert_edge(source_vertex_id, new_vertex_id);
-    return new_vertex_id;
-  }();
-  if (depth == params_.max_depth) {
-    return;
-  }
-  const float probability = (float)depth / (float)params_.max_depth;
-  for (int i = 0; i < params_.new_vertices_num; ++i) {
-    if (get_random_probability() > probability) {
-      generate_gray_branch(graph, mutex, new_vertex_id, depth + 1);
-    }
-  }
-}
-void GraphGenerator::generate_vertices_and_gray_edges(
-    Graph& graph,
-    const VertexId& source_vertex_id) const {
-  using JobCallback = std::function<void()>;
-  auto jobs = std::list<JobCallback>();
-  std::atomic<bool> should_terminate = false;
-  std::atomic<int> jobs_count = 0;
-  std::mutex graph_mutex;
-
-  for (int i = 0; i < params_.new_vertices_num; i++) {
-    jobs.emplace_back(
-        [this, &graph, &graph_mutex, &jobs_count, &source_vertex_id]() {
-          generate_gray_branch(graph, graph_mutex, source_vertex_id, 1);
-          ++jobs_count;
-        });
-  }
-
-  std::mutex jobs_mutex;
-  const auto worker = [&should_terminate, &jobs_mutex, &jobs]() {
-    while (true) {
-      if (should_terminate) {
-        return;
-      }
-      const auto job_optional = [&jobs_mutex,
-                                 &jobs]() -> std::optional<JobCallback> {
-        const std::lock_guard lock(jobs_mutex);
-        if (jobs.empty()) {
-          return std::nullopt;
-        }
-        const auto first_job = jobs.front();
-        jobs.pop_front();
-        return first_job;
-      }();
-      if (job_optional.has_value()) {
-        const auto& job = job_optional.value();
-        job();
-      }
-    }
-  };
-
-  const auto threads_count =
-      std::max(MAX_THREADS_COUNT, params_.new_vertices_num);
-  auto threads = std::vector<std::thread>();
-  threads.reserve(threads_count);
-
-  for (int i = 0; i < threads_count; ++i) {
-    threads.push_back(std::thread(worker));
-  }
-
-  while (jobs_count < params_.new_vertices_num) {
-  }
-
-  should_terminate = true;
-  for (auto& thread : threads) {
-    thread.join();
-  }
-}
-
-void generate_green_edges(Graph& graph, std::mutex& mutex) {
-  for (const auto& vertex : graph.get_vertices()) {
-    if (get_random_probability() < GREEN_EDGE_PROBABILITY) {
-      const std::lock_guard lock(mutex);
-      graph.insert_edge(vertex.id, vertex.id);
-    }
-  }
-}
-
-void generate_blue_edges(Graph& graph, std::mutex& mutex) {
-  for (int depth = 0; depth < graph.depth(); depth++) {
-    const auto& vertices_in_depth = graph.get_vertices_in_depth(depth);
-    for (VertexId j = 0; j < vertices_in_depth.size() - 1; j++) {
-      if (get_random_probability() < BLUE_EDGE_PROBABILITY) {
-        const auto source = vertices_in_depth[j];
-        const auto destination = vertices_in_depth[j + 1];
-        const std::lock_guard lock(mutex);
-        graph.insert_edge(source, destination);
-      }
-    }
-  }
-}
-
-void generate_yellow_edges(Graph& graph, std::mutex& mutex) {
-  for (VertexDepth depth = 1; depth < graph.depth(); depth++) {
-    const auto& vertices = graph.get_vertices_in_depth(depth);
-    const auto& vertices_next = graph.get_vertices_in_depth(depth + 1);
-    float probability = 1 - (float)depth * (1 / (float)(graph.depth() - 1));
-    for (const auto& vertex_id : vertices) {
-      if (get_random_probability() > probability) {
-        std::vector<VertexId> filtered_vertex_ids;
-        filtered_vertex_ids =
-            filter_connected_vertices(vertex_id, vertices_next, graph, mutex);
-        if (!filtered_vertex_ids.empty()) {
-          VertexId random_vertex_id = get_random_vertex_id(filtered_vertex_ids);
-          const std::lock_guard lock(mutex);
-          graph.insert_edge(vertex_id, random_vertex_id);
-        }
-      }
-    }
-  }
-}
-
-void generate_red_edges(Graph& graph, std::mutex& mutex) {
-  for (VertexDepth depth = 0; depth < graph.depth() - 1; depth++) {
-    const auto& vertices = graph.get_vertices_in_depth(depth);
-    const auto& vertices_next = graph.get_vertices_in_depth(depth + 2);
-    for (const auto& vertex : vertices) {
-      if (get_random_probability() < RED_EDGE_PROBABILITY) {
-        const std::lock_guard lock(mutex);
-        graph.insert_edge(vertex, get_random_vertex_id(vertices_next));
-      }
-    }
-  }
-}
-
-Graph GraphGenerator::generate() const {
-  Graph graph;
-  const auto vertex_zero = graph.insert_vertex();
-
-  std::mutex mutex;
-
-  generate_vertices_and_gray_edges(graph, vertex_zero);
-  std::thread green_thread(generate_green_edges, std::ref(graph),
-                           std::ref(mutex));
-
-  std::thread blue_thread(generate_blue_edges, std::ref(graph),
-                          std::ref(mutex));
-
-  std::thread yellow_thread(generate_yellow_edges, std::ref(graph),
-                            std::ref(mutex));
-
-  std::thread red_thread(generate_red_edges, std::ref(graph), std::ref(mutex));
-
-  green_thread.join();
-  blue_thread.join();
-  yellow_thread.join();
-  red_thread.join();
-
-  return graph;
-}
-}  // namespace uni_cpp_practice
+#include "graph_generator.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <optional>
+
+using VertexId = uni_cpp_practice::VertexId;
+using Graph = uni_cpp_practice::Graph;
+using GraphBuilder = uni_cpp_practice::GraphBuilder;
+using VertexIdRange = uni_cpp_practice::VertexIdRange;
+using RandomStream = uni_cpp_practice::RandomStream;
+using TaskScheduler = uni_cpp_practice::TaskScheduler;
+
+namespace {
+constexpr float GREEN_EDGE_PROBABILITY = 0.1;
+constexpr float BLUE_EDGE_PROBABILITY = 0.25;
+constexpr float RED_EDGE_PROBABILITY = 0.33;
+// Branches that deep and shallower are generated by the task that found
+// them, deeper ones are spawned as tasks of their own.
+constexpr int MAX_UNFORKED_BRANCH_DEPTH = 3;
+// Vertices of a depth a task of the level-synchronous generation handles.
+constexpr std::size_t LEVEL_SYNCHRONOUS_CHUNK_SIZE = 1024;
+// Vertices of a depth a task of a color pass handles. The random streams
+// depend on it, so changing it changes the generated graphs.
+constexpr VertexId COLOR_CHUNK_SIZE = 1024;
+
+// Substreams of the stream of the seed.
+constexpr std::uint64_t GRAY_RANDOM_STREAM = 0;
+constexpr std::uint64_t GREEN_RANDOM_STREAM = 1;
+constexpr std::uint64_t BLUE_RANDOM_STREAM = 2;
+constexpr std::uint64_t YELLOW_RANDOM_STREAM = 3;
+constexpr std::uint64_t RED_RANDOM_STREAM = 4;
+
+VertexId get_random_vertex_id(const VertexIdRange& vertices,
+                              RandomStream& random_stream) {
+  return vertices[random_stream.get_index(vertices.size())];
+}
+
+// Random vertex of `next_vertices` not adjacent to `vertex_id`, the same one
+// drawing among the vertices left after filtering out the adjacent ones
+// would give. The vertices of a depth are consecutive ids, so only the
+// neighbors within them are looked at: the index drawn among the others
+// steps over every one of them it reaches. O(log degree + neighbors in the
+// depth).
+std::optional<VertexId> get_random_unconnected_vertex_id(
+    const VertexId& vertex_id,
+    const VertexIdRange& next_vertices,
+    const Graph& graph,
+    RandomStream& random_stream) {
+  if (next_vertices.empty())
+    return std::nullopt;
+  const auto first_vertex_id = next_vertices[0];
+  const VertexId vertices_count = next_vertices.size();
+  assert(next_vertices[vertices_count - 1] - first_vertex_id + 1 ==
+             vertices_count &&
+         "Vertices of the depth are not consecutive ids!");
+  const auto neighbors = graph.neighbors(vertex_id, first_vertex_id,
+                                         first_vertex_id + vertices_count);
+  if (neighbors.size() == vertices_count)
+    return std::nullopt;
+  VertexId index = random_stream.get_index(vertices_count - neighbors.size());
+  for (const auto& neighbor : neighbors) {
+    if (neighbor.vertex_id - first_vertex_id > index)
+      break;
+    index++;
+  }
+  return first_vertex_id + index;
+}
+}  // namespace
+
+namespace uni_cpp_practice {
+
+GraphGenerator::GraphGenerator(const Params& params,
+                               std::shared_ptr<TaskScheduler> task_scheduler)
+    : params_(params),
+      task_scheduler_(task_scheduler != nullptr
+                          ? std::move(task_scheduler)
+                          : std::make_shared<TaskScheduler>()) {}
+
+void GraphGenerator::generate_gray_branch(
+    GraphBuilder& builder,
+    TaskScheduler& scheduler,
+    GrayBranch& branch,
+    const VertexId& source_vertex_id,
+    VertexDepth depth,
+    RandomStream random_stream) const {
+  const auto new_vertex_id = builder.insert_vertex();
+  branch.edges.emplace_back(source_vertex_id, new_vertex_id,
+                            Edge::Color::Gray);
+  if (static_cast<int>(depth) == params_.max_depth) {
+    return;
+  }
+  const float probability = (float)depth / (float)params_.max_depth;
+  const bool should_fork =
+      params_.max_depth - depth > MAX_UNFORKED_BRANCH_DEPTH;
+  // Every one of new_vertices_num new vertices is generated with the
+  // probability 1 - `probability`, so their count is drawn at once.
+  const auto new_vertices_count =
+      random_stream.get_binomial(params_.new_vertices_num, 1 - probability);
+  for (int i = 0; i < new_vertices_count; ++i) {
+    if (!should_fork) {
+      generate_gray_branch(builder, scheduler, branch, new_vertex_id,
+                           depth + 1, random_stream.get_substream(i));
+      continue;
+    }
+    auto& fork = branch.forks.emplace_back(branch.edges.size(),
+                                           std::make_unique<GrayBranch>());
+    scheduler.spawn([this, &builder, &scheduler, &fork_branch = *fork.second,
+                     new_vertex_id, depth,
+                     fork_random_stream = random_stream.get_substream(i)]() {
+      generate_gray_branch(builder, scheduler, fork_branch, new_vertex_id,
+                           depth + 1, fork_random_stream);
+    });
+  }
+}
+
+void GraphGenerator::GrayBranch::append_edges(
+    std::vector<GraphBuilder::EdgeRecord>& all_edges) const {
+  auto begin = edges.begin();
+  for (const auto& [edges_count, fork] : forks) {
+    all_edges.insert(all_edges.end(), begin, edges.begin() + edges_count);
+    begin = edges.begin() + edges_count;
+    fork->append_edges(all_edges);
+  }
+  all_edges.insert(all_edges.end(), begin, edges.end());
+}
+
+void GraphGenerator::generate_vertices_and_gray_edges(
+    GraphBuilder& builder,
+    const VertexId& source_vertex_id) const {
+  if (params_.tree_generation == TreeGeneration::LevelSynchronous)
+    generate_gray_edges_level_synchronous(builder, source_vertex_id);
+  else
+    generate_gray_edges_depth_first(builder, source_vertex_id);
+}
+
+void GraphGenerator::generate_gray_edges_depth_first(
+    GraphBuilder& builder,
+    const VertexId& source_vertex_id) const {
+  const auto random_stream =
+      RandomStream(params_.seed).get_substream(GRAY_RANDOM_STREAM);
+  auto& scheduler = *task_scheduler_;
+  auto root = GrayBranch();
+  scheduler.run([&]() {
+    for (int i = 0; i < params_.new_vertices_num; i++) {
+      auto& fork = root.forks.emplace_back(0, std::make_unique<GrayBranch>());
+      scheduler.spawn([this, &builder, &scheduler,
+                       &fork_branch = *fork.second, &source_vertex_id,
+                       fork_random_stream = random_stream.get_substream(i)]() {
+        generate_gray_branch(builder, scheduler, fork_branch,
+                             source_vertex_id, 1, fork_random_stream);
+      });
+    }
+  });
+
+  // Vertices are numbered in the order of the edges, so the edges go to the
+  // builder in the order a single thread would have generated them, not in
+  // the order the tasks finished.
+  auto edges = std::vector<GraphBuilder::EdgeRecord>();
+  root.append_edges(edges);
+  builder.insert_edges(std::move(edges));
+}
+
+void GraphGenerator::generate_gray_edges_level_synchronous(
+    GraphBuilder& builder,
+    const VertexId& source_vertex_id) const {
+  // Vertices of the current depth: the first id, their random streams and
+  // the counts of their new vertices. A vertex draws exactly what it draws
+  // in generate_gray_branch(), so the tree is the same, and the edges of a
+  // depth are emitted in the order of their source vertices, so the
+  // vertices of every depth are numbered the same way too.
+  auto first_vertex_id = source_vertex_id;
+  auto random_streams = std::vector<RandomStream>();
+  auto new_vertices_counts = std::vector<VertexId>();
+  auto new_vertices_offsets = std::vector<VertexId>();
+  auto& scheduler = *task_scheduler_;
+
+  // Calls `callback(begin, end)` for chunks of [0, size) in parallel.
+  const auto for_each_chunk = [&scheduler](std::size_t size,
+                                           const auto& callback) {
+    scheduler.run([&scheduler, size, &callback]() {
+      for (std::size_t begin = 0; begin < size;
+           begin += LEVEL_SYNCHRONOUS_CHUNK_SIZE) {
+        const auto end = std::min(size, begin + LEVEL_SYNCHRONOUS_CHUNK_SIZE);
+        scheduler.spawn([&callback, begin, end]() { callback(begin, end); });
+      }
+    });
+  };
+
+  // Vertex 0 gets all its new vertices, every one with its own stream.
+  const auto random_stream =
+      RandomStream(params_.seed).get_substream(GRAY_RANDOM_STREAM);
+  if (params_.new_vertices_num > 0) {
+    first_vertex_id = builder.insert_vertices(params_.new_vertices_num);
+    auto edges = std::vector<GraphBuilder::EdgeRecord>();
+    edges.reserve(params_.new_vertices_num);
+    for (int i = 0; i < params_.new_vertices_num; i++) {
+      edges.emplace_back(source_vertex_id, first_vertex_id + i,
+                         Edge::Color::Gray);
+      random_streams.push_back(random_stream.get_substream(i));
+    }
+    builder.insert_edges(std::move(edges));
+  }
+
+  for (VertexDepth depth = 1;
+       static_cast<int>(depth) < params_.max_depth && !random_streams.empty();
+       depth++) {
+    const float probability = (float)depth / (float)params_.max_depth;
+    const auto vertices_count = random_streams.size();
+
+    new_vertices_counts.resize(vertices_count);
+    for_each_chunk(vertices_count, [&](std::size_t begin, std::size_t end) {
+      for (auto i = begin; i < end; i++) {
+        new_vertices_counts[i] = random_streams[i].get_binomial(
+            params_.new_vertices_num, 1 - probability);
+      }
+    });
+
+    new_vertices_offsets.resize(vertices_count + 1);
+    new_vertices_offsets[0] = 0;
+    std::partial_sum(new_vertices_counts.begin(), new_vertices_counts.end(),
+                     new_vertices_offsets.begin() + 1);
+    const auto new_vertices_count = new_vertices_offsets.back();
+    if (new_vertices_count == 0) {
+      break;
+    }
+
+    // Every vertex knows where its edges go, so they are emitted without
+    // any locking.
+    const auto new_first_vertex_id =
+        builder.insert_vertices(new_vertices_count);
+    auto edges = std::vector<GraphBuilder::EdgeRecord>(
+        new_vertices_count, GraphBuilder::EdgeRecord(0, 0, Edge::Color::Gray));
+    auto new_random_streams =
+        std::vector<RandomStream>(new_vertices_count, RandomStream(0));
+    for_each_chunk(vertices_count, [&](std::size_t begin, std::size_t end) {
+      for (auto i = begin; i < end; i++) {
+        const auto offset = new_vertices_offsets[i];
+        for (VertexId j = 0; j < new_vertices_counts[i]; j++) {
+          edges[offset + j].source = first_vertex_id + i;
+          edges[offset + j].destination = new_first_vertex_id + offset + j;
+          new_random_streams[offset + j] = random_streams[i].get_substream(j);
+        }
+      }
+    });
+    builder.insert_edges(std::move(edges));
+
+    first_vertex_id = new_first_vertex_id;
+    random_streams = std::move(new_random_streams);
+  }
+}
+
+// Every color pass proposes its edges for a chunk of the vertices of one
+// depth, [begin, end) of their positions in the depth, with a random stream
+// of its own. So the chunks are proposed in any order, on any thread, and
+// still propose the same edges. The probabilities of all the vertices of a
+// chunk are drawn in one batch first.
+using ChunkProbabilities = std::array<float, COLOR_CHUNK_SIZE>;
+
+void generate_green_edges(const Graph& graph,
+                          VertexDepth depth,
+                          VertexId begin,
+                          VertexId end,
+                          RandomStream random_stream,
+                          std::vector<GraphBuilder::EdgeRecord>& edges) {
+  const auto vertices_in_depth = graph.get_vertices_in_depth(depth);
+  auto probabilities = ChunkProbabilities();
+  random_stream.get_probabilities(probabilities.data(),
+                                  probabilities.data() + (end - begin));
+  for (auto j = begin; j < end; j++) {
+    if (probabilities[j - begin] < GREEN_EDGE_PROBABILITY) {
+      edges.emplace_back(vertices_in_depth[j], vertices_in_depth[j]);
+    }
+  }
+}
+
+void generate_blue_edges(const Graph& graph,
+                         VertexDepth depth,
+                         VertexId begin,
+                         VertexId end,
+                         RandomStream random_stream,
+                         std::vector<GraphBuilder::EdgeRecord>& edges) {
+  const auto vertices_in_depth = graph.get_vertices_in_depth(depth);
+  if (end == vertices_in_depth.size()) {
+    end--;
+  }
+  if (begin >= end) {
+    return;
+  }
+  auto probabilities = ChunkProbabilities();
+  random_stream.get_probabilities(probabilities.data(),
+                                  probabilities.data() + (end - begin));
+  for (auto j = begin; j < end; j++) {
+    if (probabilities[j - begin] < BLUE_EDGE_PROBABILITY) {
+      edges.emplace_back(vertices_in_depth[j], vertices_in_depth[j + 1]);
+    }
+  }
+}
+
+void generate_yellow_edges(const Graph& graph,
+                           VertexDepth depth,
+                           VertexId begin,
+                           VertexId end,
+                           RandomStream random_stream,
+                           std::vector<GraphBuilder::EdgeRecord>& edges) {
+  const auto vertices = graph.get_vertices_in_depth(depth);
+  const auto vertices_next = graph.get_vertices_in_depth(depth + 1);
+  float probability = 1 - (float)depth * (1 / (float)(graph.depth() - 1));
+  auto probabilities = ChunkProbabilities();
+  random_stream.get_probabilities(probabilities.data(),
+                                  probabilities.data() + (end - begin));
+  for (auto j = begin; j < end; j++) {
+    const auto vertex_id = vertices[j];
+    if (probabilities[j - begin] > probability) {
+      const auto next_vertex_id = get_random_unconnected_vertex_id(
+          vertex_id, vertices_next, graph, random_stream);
+      if (next_vertex_id.has_value()) {
+        edges.emplace_back(vertex_id, next_vertex_id.value());
+      }
+    }
+  }
+}
+
+void generate_red_edges(const Graph& graph,
+                        VertexDepth depth,
+                        VertexId begin,
+                        VertexId end,
+                        RandomStream random_stream,
+                        std::vector<GraphBuilder::EdgeRecord>& edges) {
+  const auto vertices = graph.get_vertices_in_depth(depth);
+  const auto vertices_next = graph.get_vertices_in_depth(depth + 2);
+  auto probabilities = ChunkProbabilities();
+  random_stream.get_probabilities(probabilities.data(),
+                                  probabilities.data() + (end - begin));
+  for (auto j = begin; j < end; j++) {
+    if (probabilities[j - begin] < RED_EDGE_PROBABILITY) {
+      edges.emplace_back(vertices[j],
+                         get_random_vertex_id(vertices_next, random_stream));
+    }
+  }
+}
+
+Graph GraphGenerator::generate() const {
+  auto graph = Graph();
+  auto graph_pool = GraphPool();
+  generate(graph, graph_pool);
+  return graph;
+}
+
+void GraphGenerator::generate(Graph& graph, GraphPool& graph_pool) const {
+  const auto tree = generate_tree(graph_pool);
+  generate_colored_edges(*tree, graph);
+}
+
+std::shared_ptr<const Graph> GraphGenerator::generate_tree(
+    GraphPool& graph_pool) const {
+  auto builder = GraphBuilder();
+  const auto vertex_zero = builder.insert_vertex();
+  generate_vertices_and_gray_edges(builder, vertex_zero);
+  auto tree = graph_pool.acquire();
+  builder.build(*tree);
+  return graph_pool.share(std::move(tree));
+}
+
+void GraphGenerator::generate_colored_edges(const Graph& tree,
+                                            Graph& graph) const {
+  // The color passes only need to read the gray tree: edges of different
+  // colors never connect the same pair of vertices, and yellow edges are
+  // checked against the gray ones. The tree numbers the vertices of every
+  // depth consecutively, so the passes read every depth in memory order.
+  //
+  // Every chunk of every pass is a task proposing edges into a list of its
+  // own, there is nothing to lock. The lists then go to a builder starting
+  // from the tree in a fixed order, whichever task finished first, and
+  // build() drops repeated vertex pairs in parallel.
+  const auto random_stream = RandomStream(params_.seed);
+  const VertexDepth depths_count = tree.depth() + 1;
+  struct ColorPass {
+    decltype(&generate_green_edges) generate_edges;
+    std::uint64_t random_stream;
+    // Depths the pass proposes edges for: [first_depth, depths_count -
+    // skipped_last_depths_count).
+    VertexDepth first_depth;
+    VertexDepth skipped_last_depths_count;
+  };
+  const auto color_passes = std::array<ColorPass, 4>{{
+      {generate_green_edges, GREEN_RANDOM_STREAM, 0, 0},
+      {generate_blue_edges, BLUE_RANDOM_STREAM, 0, 1},
+      {generate_yellow_edges, YELLOW_RANDOM_STREAM, 1, 1},
+      {generate_red_edges, RED_RANDOM_STREAM, 0, 2},
+  }};
+  struct Chunk {
+    const ColorPass* color_pass;
+    VertexDepth depth;
+    VertexId begin;
+    VertexId end;
+    RandomStream random_stream;
+  };
+  auto chunks = std::vector<Chunk>();
+  for (const auto& color_pass : color_passes) {
+    const auto color_random_stream =
+        random_stream.get_substream(color_pass.random_stream);
+    for (auto depth = color_pass.first_depth;
+         depth + color_pass.skipped_last_depths_count < depths_count;
+         depth++) {
+      const auto depth_random_stream =
+          color_random_stream.get_substream(depth);
+      const VertexId vertices_count = tree.get_vertices_in_depth(depth).size();
+      for (VertexId begin = 0; begin < vertices_count;
+           begin += COLOR_CHUNK_SIZE) {
+        chunks.push_back(
+            {&color_pass, depth, begin,
+             std::min<VertexId>(vertices_count, begin + COLOR_CHUNK_SIZE),
+             depth_random_stream.get_substream(begin / COLOR_CHUNK_SIZE)});
+      }
+    }
+  }
+
+  auto chunks_edges =
+      std::vector<std::vector<GraphBuilder::EdgeRecord>>(chunks.size());
+  auto& scheduler = *task_scheduler_;
+  scheduler.run([&]() {
+    for (std::size_t i = 0; i < chunks.size(); i++) {
+      scheduler.spawn([&tree, &chunk = chunks[i],
+                       &chunk_edges = chunks_edges[i]]() {
+        chunk.color_pass->generate_edges(tree, chunk.depth, chunk.begin,
+                                         chunk.end, chunk.random_stream,
+                                         chunk_edges);
+      });
+    }
+  });
+
+  auto edges = std::vector<GraphBuilder::EdgeRecord>();
+  std::size_t edges_count = 0;
+  for (const auto& chunk_edges : chunks_edges) {
+    edges_count += chunk_edges.size();
+  }
+  edges.reserve(edges_count);
+  for (const auto& chunk_edges : chunks_edges) {
+    edges.insert(edges.end(), chunk_edges.begin(), chunk_edges.end());
+  }
+  auto builder = GraphBuilder(tree);
+  builder.insert_edges(std::move(edges));
+  builder.build(graph);
+}
+}  // namespace uni_cpp_practice
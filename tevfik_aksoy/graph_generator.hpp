@@ -1,31 +1,86 @@
-#pragma once
-
-#include <mutex>
-#include "graph.hpp"
-
-namespace uni_cpp_practice {
-
-class GraphGenerator {
- public:
-  struct Params {
-    explicit Params(int depth = 0, int _new_vertices_num = 0)
-        : max_depth(depth), new_vertices_num(_new_vertices_num) {}
-
-    const int max_depth = 0;
-    const int new_vertices_num = 0;
-  };
-
-  explicit GraphGenerator(const Params& params = Params()) : params_(params) {}
-
-  Graph generate() const;
-
- private:
-  const Params params_ = Params();
-  void generate_vertices_and_gray_edges(Graph& graph,
-                                        const VertexId& source_vertex_id) const;
-  void generate_gray_branch(Graph& graph,
-                            std::mutex& mutex,
-                            const VertexId& source_vertex_id,
-                            VertexDepth depth) const;
-};
-}  // namespace uni_cpp_practice
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "graph.hpp"
+#include "graph_builder.hpp"
+#include "graph_pool.hpp"
+#include "random_stream.hpp"
+#include "task_scheduler.hpp"
+
+namespace uni_cpp_practice {
+
+class GraphGenerator {
+ public:
+  // How the gray tree is generated: branch by branch, every branch as deep
+  // as it goes, or depth by depth. Both give the same vertices and edges,
+  // only the gray edges are numbered in a different order.
+  enum class TreeGeneration { DepthFirst, LevelSynchronous };
+
+  struct Params {
+    explicit Params(
+        int depth = 0,
+        int _new_vertices_num = 0,
+        std::uint64_t _seed = 0,
+        TreeGeneration _tree_generation = TreeGeneration::DepthFirst)
+        : max_depth(depth),
+          new_vertices_num(_new_vertices_num),
+          seed(_seed),
+          tree_generation(_tree_generation) {}
+
+    const int max_depth = 0;
+    const int new_vertices_num = 0;
+    // The same params generate the same graph, whatever the count of
+    // threads generating it.
+    const std::uint64_t seed = 0;
+    const TreeGeneration tree_generation = TreeGeneration::DepthFirst;
+  };
+
+  // Tasks run on `task_scheduler`, which may be shared with other
+  // generators. Without one the generator creates its own.
+  explicit GraphGenerator(
+      const Params& params = Params(),
+      std::shared_ptr<TaskScheduler> task_scheduler = nullptr);
+
+  Graph generate() const;
+  // Same, but builds into `graph` and takes scratch graphs from `graph_pool`.
+  void generate(Graph& graph, GraphPool& graph_pool) const;
+
+ private:
+  const Params params_ = Params();
+  const std::shared_ptr<TaskScheduler> task_scheduler_;
+  // Vertices of the graph and the gray edges between them, with every depth
+  // numbered consecutively.
+  std::shared_ptr<const Graph> generate_tree(GraphPool& graph_pool) const;
+  // Builds `tree` and the edges of the other colors into `graph`.
+  void generate_colored_edges(const Graph& tree, Graph& graph) const;
+  // Gray edges of a branch generated by one task, and the branches it
+  // spawned as tasks of their own. A fork goes after the given count of
+  // `edges`.
+  struct GrayBranch {
+    std::vector<GraphBuilder::EdgeRecord> edges;
+    std::vector<std::pair<std::size_t, std::unique_ptr<GrayBranch>>> forks;
+
+    // Appends the edges of the branch and its forks in depth-first order.
+    void append_edges(std::vector<GraphBuilder::EdgeRecord>& all_edges) const;
+  };
+
+  void generate_vertices_and_gray_edges(GraphBuilder& builder,
+                                        const VertexId& source_vertex_id) const;
+  void generate_gray_edges_depth_first(GraphBuilder& builder,
+                                       const VertexId& source_vertex_id) const;
+  void generate_gray_edges_level_synchronous(
+      GraphBuilder& builder,
+      const VertexId& source_vertex_id) const;
+  // `random_stream` is the stream of the branch, every branch starting from
+  // the new vertex takes a substream of it.
+  void generate_gray_branch(GraphBuilder& builder,
+                            TaskScheduler& scheduler,
+                            GrayBranch& branch,
+                            const VertexId& source_vertex_id,
+                            VertexDepth depth,
+                            RandomStream random_stream) const;
+};
+}  // namespace uni_cpp_practice
@@ -0,0 +1,48 @@
+#include "graph_pool.hpp"
+
+namespace uni_cpp_practice {
+
+GraphPool::GraphPool() : state_(std::make_shared<State>()) {}
+
+std::unique_ptr<Graph> GraphPool::acquire() {
+  const std::lock_guard lock(state_->mutex);
+  auto& statistics = state_->statistics;
+  statistics.acquired_count++;
+  if (state_->graphs.empty()) {
+    return std::make_unique<Graph>();
+  }
+  auto graph = std::move(state_->graphs.back());
+  state_->graphs.pop_back();
+  statistics.reused_count++;
+  return graph;
+}
+
+void GraphPool::release(std::unique_ptr<Graph> graph) {
+  release(*state_, std::move(graph));
+}
+
+void GraphPool::release(State& state, std::unique_ptr<Graph> graph) {
+  const auto reused_bytes = graph->reused_bytes();
+  graph->clear();
+  const std::lock_guard lock(state.mutex);
+  state.statistics.reused_bytes += reused_bytes;
+  state.graphs.push_back(std::move(graph));
+}
+
+std::shared_ptr<const Graph> GraphPool::share(std::unique_ptr<Graph> graph) {
+  const auto weak_state = std::weak_ptr<State>(state_);
+  return std::shared_ptr<const Graph>(
+      graph.release(), [weak_state](const Graph* shared_graph) {
+        auto owned_graph =
+            std::unique_ptr<Graph>(const_cast<Graph*>(shared_graph));
+        if (const auto state = weak_state.lock()) {
+          release(*state, std::move(owned_graph));
+        }
+      });
+}
+
+GraphPool::Statistics GraphPool::get_statistics() const {
+  const std::lock_guard lock(state_->mutex);
+  return state_->statistics;
+}
+}  // namespace uni_cpp_practice
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "graph.hpp"
+
+namespace uni_cpp_practice {
+// Keeps cleared graphs around for reuse, so that generating many graphs of a
+// similar size doesn't allocate their storage over and over again. A reused
+// graph keeps its memory and only allocates more when it is filled with a
+// bigger graph than it held before.
+class GraphPool {
+ public:
+  struct Statistics {
+    int acquired_count = 0;
+    int reused_count = 0;
+    // Memory graphs kept from their earlier use and used again instead of
+    // allocating it, see Graph::reused_bytes(). Counted when they come back
+    // to the pool.
+    std::size_t reused_bytes = 0;
+  };
+
+  GraphPool();
+
+  // Returns an empty graph, a reused one if the pool has any.
+  std::unique_ptr<Graph> acquire();
+  void release(std::unique_ptr<Graph> graph);
+
+  // Shares `graph` and returns it to the pool when its last owner is gone.
+  // Graphs outliving the pool are deleted instead.
+  std::shared_ptr<const Graph> share(std::unique_ptr<Graph> graph);
+
+  Statistics get_statistics() const;
+
+ private:
+  struct State {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Graph>> graphs;
+    Statistics statistics;
+  };
+
+  std::shared_ptr<State> state_;
+
+  static void release(State& state, std::unique_ptr<Graph> graph);
+};
+}  // namespace uni_cpp_practice
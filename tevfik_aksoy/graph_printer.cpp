@@ -1,64 +1,74 @@
-#include "graph_printer.hpp"
-#include <sstream>
-
-namespace {
-
-std::string print_vertex(const uni_cpp_practice::Vertex& vertex) {
-  std::string json_string;
-  json_string +=
-      "\t{ \"id\": " + std::to_string(vertex.id) + ", \"edge_ids\": [";
-  for (int i = 0; i < vertex.get_edge_ids().size(); i++) {
-    json_string += std::to_string(vertex.get_edge_ids()[i]);
-    if (i + 1 != vertex.get_edge_ids().size())
-      json_string += ", ";
-  }
-  json_string += "], \"depth\": " + std::to_string(vertex.depth) + "}";
-  return json_string;
-}
-
-std::string print_edge(const uni_cpp_practice::Edge& edge) {
-  std::string json_string;
-  json_string += "\t{ \"id\": " + std::to_string(edge.id) +
-                 ", \"vertex_ids\": [" + std::to_string(edge.source) + ", " +
-                 std::to_string(edge.destination) + R"(], "color": ")" +
-                 color_to_string(edge.color) + "\" }";
-  return json_string;
-}
-
-}  // namespace
-
-namespace uni_cpp_practice {
-std::string GraphPrinter::print() const {
-  std::string json_string;
-  json_string += "{\n\"vertices\": [\n";
-  for (int i = 0; i < graph_.get_vertices().size(); i++) {
-    json_string += print_vertex(graph_.get_vertices()[i]);
-    if (i + 1 != graph_.get_vertices().size())
-      json_string += ",\n";
-  }
-  json_string += "\n  ],\n";
-
-  json_string += "\"edges\": [\n";
-  for (int i = 0; i < graph_.get_edges().size(); i++) {
-    json_string += print_edge(graph_.get_edges()[i]);
-    if (i + 1 != graph_.get_edges().size())
-      json_string += ",\n";
-  }
-  json_string += "\n  ]\n}\n";
-  return json_string;
-}
-
-std::string GraphPrinter::print_path(const GraphTraverser::Path& path) {
-  std::stringstream ss;
-  std::string path_string = "  {vertices: [";
-  ss << path_string;
-  for (int i = 0; i < path.vertex_ids.size(); i++) {
-    ss << std::to_string(path.vertex_ids[i]);
-    if (i != path.vertex_ids.size() - 1)
-      ss << ",";
-  }
-  ss << "], distance: " + std::to_string(path.distance) + "}";
-  return ss.str();
-}
-
-}  // namespace uni_cpp_practice
+#include "graph_printer.hpp"
+#include <sstream>
+
+namespace {
+
+std::string print_vertex(const uni_cpp_practice::Vertex& vertex,
+                         const uni_cpp_practice::EdgeIdList& edge_ids) {
+  std::string json_string;
+  json_string +=
+      "\t{ \"id\": " + std::to_string(vertex.id) + ", \"edge_ids\": [";
+  for (uni_cpp_practice::EdgeId i = 0; i < edge_ids.size(); i++) {
+    json_string += std::to_string(edge_ids[i]);
+    if (i + 1 != edge_ids.size())
+      json_string += ", ";
+  }
+  json_string += "], \"depth\": " + std::to_string(vertex.depth) + "}";
+  return json_string;
+}
+
+std::string print_edge(const uni_cpp_practice::Edge& edge) {
+  std::string json_string;
+  json_string += "\t{ \"id\": " + std::to_string(edge.id) +
+                 ", \"vertex_ids\": [" + std::to_string(edge.source) + ", " +
+                 std::to_string(edge.destination) + R"(], "color": ")" +
+                 color_to_string(edge.color) + "\" }";
+  return json_string;
+}
+
+}  // namespace
+
+namespace uni_cpp_practice {
+std::string GraphPrinter::print() const {
+  std::string json_string;
+  json_string += "{\n\"vertices\": [\n";
+  // Removed vertices and edges are skipped, their ids stay as they are.
+  VertexId printed_vertices_count = 0;
+  for (VertexId i = 0; i < graph_.vertex_ids_count(); i++) {
+    if (!graph_.does_vertex_exist(i))
+      continue;
+    json_string +=
+        print_vertex(graph_.get_vertex_unchecked(i),
+                     graph_.get_vertex_edge_ids(i));
+    if (++printed_vertices_count != graph_.vertices_count())
+      json_string += ",\n";
+  }
+  json_string += "\n  ],\n";
+
+  json_string += "\"edges\": [\n";
+  EdgeId printed_edges_count = 0;
+  for (EdgeId i = 0; i < graph_.edge_ids_count(); i++) {
+    if (!graph_.does_edge_exist(i))
+      continue;
+    json_string += print_edge(graph_.get_edge_unchecked(i));
+    if (++printed_edges_count != graph_.edges_count())
+      json_string += ",\n";
+  }
+  json_string += "\n  ]\n}\n";
+  return json_string;
+}
+
+std::string GraphPrinter::print_path(const GraphTraverser::Path& path) {
+  std::stringstream ss;
+  std::string path_string = "  {vertices: [";
+  ss << path_string;
+  for (std::size_t i = 0; i < path.vertex_ids.size(); i++) {
+    ss << std::to_string(path.vertex_ids[i]);
+    if (i != path.vertex_ids.size() - 1)
+      ss << ",";
+  }
+  ss << "], distance: " + std::to_string(path.distance) + "}";
+  return ss.str();
+}
+
+}  // namespace uni_cpp_practice
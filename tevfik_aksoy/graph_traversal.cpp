@@ -1,131 +1,166 @@
-#include "graph_traversal.hpp"
-#include <atomic>
-#include <cassert>
-#include <climits>
-#include <functional>
-#include <iostream>
-#include <list>
-#include <map>
-#include <mutex>
-#include <queue>
-#include <thread>
-
-namespace {
-const int MAX_WORKERS_COUNT = std::thread::hardware_concurrency();
-}  // namespace
-
-namespace uni_cpp_practice {
-
-GraphTraverser::GraphTraverser(const Graph& graph) : graph_(graph) {}
-
-std::vector<GraphTraverser::Path> GraphTraverser::traverse_graph() {
-  std::list<std::function<void()>> jobs;
-  std::mutex path_mutex;
-  std::vector<GraphTraverser::Path> paths;
-  paths.reserve(graph_.get_vertices_in_depth(graph_.depth()).size());
-  std::atomic<int> jobs_count =
-      graph_.get_vertices_in_depth(graph_.depth()).size();
-
-  for (const auto& vertex_id : graph_.get_vertices_in_depth(graph_.depth()))
-    jobs.emplace_back([this, &jobs_count, &vertex_id, &paths, &path_mutex]() {
-      auto path = find_shortest_path(0, vertex_id);
-      {
-        std::lock_guard lock(path_mutex);
-        paths.emplace_back(path);
-      }
-      jobs_count--;
-    });
-
-  std::atomic<bool> should_terminate = false;
-  std::mutex jobs_mutex;
-  auto worker = [&should_terminate, &jobs_mutex, &jobs]() {
-    while (true) {
-      if (should_terminate) {
-        return;
-      }
-      const auto job_optional =
-          [&jobs_mutex, &jobs]() -> std::optional<std::function<void()>> {
-        const std::lock_guard lock(jobs_mutex);
-        if (jobs.empty()) {
-          return std::nullopt;
-        }
-        const auto job = jobs.front();
-        jobs.pop_front();
-        return job;
-      }();
-      if (job_optional.has_value()) {
-        const auto& job = job_optional.value();
-        job();
-      }
-    }
-  };
-
-  const auto threads_number = MAX_WORKERS_COUNT;
-  auto threads = std::vector<std::thread>();
-  threads.reserve(threads_number);
-
-  for (int i = 0; i < threads_number; i++) {
-    threads.emplace_back(worker);
-  }
-
-  while (jobs_count != 0) {
-  }
-
-  should_terminate = true;
-  for (auto& thread : threads) {
-    thread.join();
-  }
-
-  return paths;
-}
-
-GraphTraverser::Path GraphTraverser::find_shortest_path(
-    VertexId source_vertex_id,
-    VertexId destination_vertex_id) {
-  assert(graph_.does_vertex_exist(source_vertex_id) &&
-         "Source vertex doesn't exist!");
-  assert(graph_.does_vertex_exist(destination_vertex_id) &&
-         "Destination vertex doesn't exist!");
-
-  std::priority_queue<std::pair<VertexId, Distance>,
-                      std::vector<std::pair<VertexId, Distance>>,
-                      std::greater<std::pair<VertexId, Distance>>>
-      priority_queue;
-
-  std::map<VertexId, VertexId> closest_vertices_map;
-  std::vector<VertexId> path;
-
-  std::vector<Distance> distances(graph_.get_vertices().size(), INT_MAX);
-
-  priority_queue.push(std::make_pair(source_vertex_id, 0));
-  distances[source_vertex_id] = 0;
-
-  while (!priority_queue.empty()) {
-    VertexId closest_vertex_id = priority_queue.top().first;
-    priority_queue.pop();
-    for (const auto& vertex_id :
-         graph_.get_adjacent_vertex_ids(closest_vertex_id)) {
-      Distance distance = 1;
-      if (distances[vertex_id] > distances[closest_vertex_id] + distance) {
-        closest_vertices_map[vertex_id] = closest_vertex_id;
-        distances[vertex_id] = distances[closest_vertex_id] + distance;
-        priority_queue.push(std::make_pair(vertex_id, distances[vertex_id]));
-      }
-    }
-  }
-
-  auto vertex_id = destination_vertex_id;
-  while (true) {
-    path.push_back(vertex_id);
-    vertex_id = closest_vertices_map[vertex_id];
-    if (vertex_id == 0) {
-      path.push_back(vertex_id);
-      break;
-    }
-  }
-  std::reverse(path.begin(), path.end());
-
-  Path shortest_path(path, distances[destination_vertex_id]);
-  return shortest_path;
-}
-}  // namespace uni_cpp_practice
+#include "graph_traversal.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <climits>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <variant>
+
+namespace {
+using uni_cpp_practice::CompressedGraph;
+using uni_cpp_practice::CsrGraph;
+using uni_cpp_practice::Graph;
+using uni_cpp_practice::GraphTraverser;
+using uni_cpp_practice::VertexId;
+
+const int MAX_WORKERS_COUNT = std::thread::hardware_concurrency();
+
+using uni_cpp_practice::EdgeDirection;
+
+std::variant<CsrGraph, CompressedGraph> make_traversed_graph(
+    const Graph& graph,
+    GraphTraverser::Representation representation,
+    EdgeDirection direction) {
+  if (representation == GraphTraverser::Representation::Compressed)
+    return CompressedGraph(graph, direction);
+  return graph.freeze(direction);
+}
+
+// Every edge has the length of 1, so breadth-first search finds the
+// shortest paths.
+template <typename TraversedGraph>
+GraphTraverser::Path find_shortest_path(const TraversedGraph& graph,
+                                        VertexId source_vertex_id,
+                                        VertexId destination_vertex_id) {
+  using Distance = GraphTraverser::Distance;
+  assert(graph.does_vertex_exist(source_vertex_id) &&
+         "Source vertex doesn't exist!");
+  assert(graph.does_vertex_exist(destination_vertex_id) &&
+         "Destination vertex doesn't exist!");
+
+  std::vector<VertexId> path;
+  std::vector<Distance> distances(graph.vertices_count(), INT_MAX);
+  // Previous vertex on the shortest path to every vertex, indexed by id.
+  std::vector<VertexId> closest_vertex_ids(graph.vertices_count(), 0);
+  std::queue<VertexId> queue;
+
+  queue.push(source_vertex_id);
+  distances[source_vertex_id] = 0;
+
+  while (!queue.empty() && distances[destination_vertex_id] == INT_MAX) {
+    const VertexId closest_vertex_id = queue.front();
+    queue.pop();
+    for (const auto& vertex_id :
+         graph.get_adjacent_vertex_ids(closest_vertex_id)) {
+      if (distances[vertex_id] == INT_MAX) {
+        closest_vertex_ids[vertex_id] = closest_vertex_id;
+        distances[vertex_id] = distances[closest_vertex_id] + 1;
+        queue.push(vertex_id);
+      }
+    }
+  }
+
+  auto vertex_id = destination_vertex_id;
+  while (true) {
+    path.push_back(vertex_id);
+    vertex_id = closest_vertex_ids[vertex_id];
+    if (vertex_id == 0) {
+      path.push_back(vertex_id);
+      break;
+    }
+  }
+  std::reverse(path.begin(), path.end());
+
+  return GraphTraverser::Path(path, distances[destination_vertex_id]);
+}
+}  // namespace
+
+namespace uni_cpp_practice {
+
+GraphTraverser::GraphTraverser(const Graph& graph,
+                               Representation representation,
+                               EdgeDirection direction)
+    : graph_(make_traversed_graph(graph, representation, direction)) {}
+
+std::vector<GraphTraverser::Path> GraphTraverser::traverse_graph() {
+  std::list<std::function<void()>> jobs;
+  std::mutex path_mutex;
+  std::vector<GraphTraverser::Path> paths;
+  const auto deepest_vertex_ids = std::visit(
+      [](const auto& graph) {
+        return graph.get_vertices_in_depth(graph.depth());
+      },
+      graph_);
+  paths.reserve(deepest_vertex_ids.size());
+  std::atomic<int> jobs_count = deepest_vertex_ids.size();
+
+  for (const auto vertex_id : deepest_vertex_ids)
+    jobs.emplace_back([this, &jobs_count, vertex_id, &paths, &path_mutex]() {
+      auto path = find_shortest_path(0, vertex_id);
+      {
+        std::lock_guard lock(path_mutex);
+        paths.emplace_back(path);
+      }
+      jobs_count--;
+    });
+
+  std::atomic<bool> should_terminate = false;
+  std::mutex jobs_mutex;
+  auto worker = [&should_terminate, &jobs_mutex, &jobs]() {
+    while (true) {
+      if (should_terminate) {
+        return;
+      }
+      const auto job_optional =
+          [&jobs_mutex, &jobs]() -> std::optional<std::function<void()>> {
+        const std::lock_guard lock(jobs_mutex);
+        if (jobs.empty()) {
+          return std::nullopt;
+        }
+        const auto job = jobs.front();
+        jobs.pop_front();
+        return job;
+      }();
+      if (job_optional.has_value()) {
+        const auto& job = job_optional.value();
+        job();
+      }
+    }
+  };
+
+  const auto threads_number = MAX_WORKERS_COUNT;
+  auto threads = std::vector<std::thread>();
+  threads.reserve(threads_number);
+
+  for (int i = 0; i < threads_number; i++) {
+    threads.emplace_back(worker);
+  }
+
+  while (jobs_count != 0) {
+  }
+
+  should_terminate = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return paths;
+}
+
+GraphTraverser::Path GraphTraverser::find_shortest_path(
+    VertexId source_vertex_id,
+    VertexId destination_vertex_id) {
+  return std::visit(
+      [source_vertex_id, destination_vertex_id](const auto& graph) {
+        return ::find_shortest_path(graph, source_vertex_id,
+                                    destination_vertex_id);
+      },
+      graph_);
+}
+}  // namespace uni_cpp_practice
@@ -1,28 +1,42 @@
-#pragma once
-#include <list>
-#include "graph.hpp"
-
-namespace uni_cpp_practice {
-class GraphTraverser {
- public:
-  using Distance = int;
-
-  struct Path {
-    Path(std::vector<VertexId> _vertex_ids, Distance _distance = 0)
-        : vertex_ids(_vertex_ids), distance(_distance) {}
-    std::vector<VertexId> vertex_ids;
-    Distance distance = 0;
-  };
-
-  GraphTraverser(const Graph& graph);
-
-  std::vector<Path> traverse_graph();
-
-  Path find_shortest_path(VertexId source_vertex_id,
-                          VertexId destination_vertex_id);
-
- private:
-  const Graph graph_;
-};
-
-}  // namespace uni_cpp_practice
+#pragma once
+#include <list>
+#include <variant>
+#include "compressed_graph.hpp"
+#include "graph.hpp"
+
+namespace uni_cpp_practice {
+class GraphTraverser {
+ public:
+  using Distance = int;
+
+  struct Path {
+    Path(std::vector<VertexId> _vertex_ids, Distance _distance = 0)
+        : vertex_ids(_vertex_ids), distance(_distance) {}
+    std::vector<VertexId> vertex_ids;
+    Distance distance = 0;
+  };
+
+  // How the traverser stores the graph: CsrGraph is faster, CompressedGraph
+  // takes less than half of its memory.
+  enum class Representation { Csr, Compressed };
+
+  // With EdgeDirection::Out paths only follow edges from their source to
+  // their destination, so less of the graph is searched, but the paths
+  // found are not always the shortest ones over all the edges: they can't
+  // go back up a depth or take a blue edge from its destination to its
+  // source, and may be longer. GraphTraversalController follows both
+  // directions.
+  GraphTraverser(const Graph& graph,
+                 Representation representation = Representation::Csr,
+                 EdgeDirection direction = EdgeDirection::Both);
+
+  std::vector<Path> traverse_graph();
+
+  Path find_shortest_path(VertexId source_vertex_id,
+                          VertexId destination_vertex_id);
+
+ private:
+  const std::variant<CsrGraph, CompressedGraph> graph_;
+};
+
+}  // namespace uni_cpp_practice
@@ -1,203 +1,285 @@
-#include <array>
-#include <chrono>
-#include <filesystem>
-#include <iomanip>
-#include <iostream>
-#include <sstream>
-#include <string>
-#include "graph.hpp"
-#include "graph_generation_controller.hpp"
-#include "graph_printer.hpp"
-#include "graph_traversal.hpp"
-#include "graph_traversal_controller.hpp"
-#include "logger.hpp"
-
-using Graph = uni_cpp_practice::Graph;
-using Edge = uni_cpp_practice::Edge;
-using GraphPrinter = uni_cpp_practice::GraphPrinter;
-using GraphGenerator = uni_cpp_practice::GraphGenerator;
-using GraphGenerationController = uni_cpp_practice::GraphGenerationController;
-using Logger = uni_cpp_practice::Logger;
-using GraphTraverser = uni_cpp_practice::GraphTraverser;
-using GraphTraversalController = uni_cpp_practice::GraphTraversalController;
-
-std::string get_date_and_time() {
-  std::time_t now =
-      std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-  std::stringstream date_time_string;
-  date_time_string << std::put_time(std::localtime(&now), "%d/%m/%Y %T");
-  return date_time_string.str();
-}
-
-int handle_depth_input() {
-  int max_depth = 0;
-  std::cout << "Enter max_depth: ";
-  do {
-    std::cin >> max_depth;
-    if (max_depth < 0)
-      std::cerr << "Depth can not be negative!\n"
-                   "Enter a non-negative max_depth: ";
-  } while (max_depth < 0);
-  return max_depth;
-}
-
-int handle_new_vertices_num_input() {
-  int new_vertices_num = 0;
-  std::cout << "Enter new_vertices_num: ";
-  do {
-    std::cin >> new_vertices_num;
-    if (new_vertices_num < 0)
-      std::cerr << "Number of new vertices created by each vertex can not be "
-                   "negative!\nEnter a non-negative new_vertices_num: ";
-  } while (new_vertices_num < 0);
-  return new_vertices_num;
-}
-
-int handle_threads_count_input() {
-  int threads_count = 0;
-  std::cout << "Enter threads_count: ";
-  do {
-    std::cin >> threads_count;
-    if (threads_count < 0)
-      std::cerr << "Count of threads can not be negative!\n"
-                   "Enter a non-negative threads_count: ";
-  } while (threads_count < 0);
-  return threads_count;
-}
-
-int handle_graphs_count_input() {
-  int graphs_count = 0;
-  std::cout << "Enter graphs_count: ";
-  do {
-    std::cin >> graphs_count;
-    if (graphs_count < 0)
-      std::cerr << "Count of graphs to be created can not be negative!\n"
-                   "Enter a non-negative graphs_count: ";
-  } while (graphs_count < 0);
-  return graphs_count;
-}
-
-void log_start(Logger& logger, const int graph_number) {
-  logger.log(get_date_and_time() + ": Graph " + std::to_string(graph_number) +
-             ", Generation Started\n");
-}
-
-void log_depth(Logger& logger, const Graph& graph) {
-  for (int j = 0; j <= graph.depth(); j++) {
-    logger.log(std::to_string(graph.get_vertices_in_depth(j).size()));
-    if (j != graph.depth())
-      logger.log(", ");
-  }
-}
-
-void log_colors(Logger& logger, const Graph& graph) {
-  const std::array<Edge::Color, 5> colors = {
-      Edge::Color::Gray, Edge::Color::Green, Edge::Color::Blue,
-      Edge::Color::Yellow, Edge::Color::Red};
-  for (int i = 0; i < colors.size(); i++) {
-    logger.log(uni_cpp_practice::color_to_string(colors[i]) + ": " +
-               std::to_string(graph.get_colored_edges(colors[i]).size()));
-    if (i + 1 != colors.size())
-      logger.log(", ");
-  }
-}
-
-void log_end(Logger& logger, const Graph& graph, int graph_number) {
-  logger.log(get_date_and_time() + ": Graph " + std::to_string(graph_number) +
-             ", Generation Finished {  \n");
-  logger.log("  depth: " + std::to_string(graph.depth()) + ",\n");
-  logger.log("  vertices: " + std::to_string(graph.get_vertices().size()) +
-             ", [");
-  log_depth(logger, graph);
-  logger.log("],\n  edges: " + std::to_string(graph.get_edges().size()) +
-             ", {");
-  log_colors(logger, graph);
-  logger.log("}\n}\n");
-}
-
-void log_paths(Logger& logger, const std::vector<GraphTraverser::Path>& paths) {
-  for (int i = 0; i < paths.size(); i++) {
-    logger.log(GraphPrinter::print_path(paths[i]));
-    if (i != paths.size() - 1)
-      logger.log(",");
-    logger.log("\n");
-  }
-}
-
-void log_traversal_start(Logger& logger, int graph_number) {
-  logger.log(get_date_and_time() + ": Graph " + std::to_string(graph_number) +
-             ", Traversal Started\n");
-}
-
-void log_traversal_end(Logger& logger,
-                       const int graph_number,
-                       const std::vector<GraphTraverser::Path>& paths) {
-  logger.log(get_date_and_time() + ": Graph " + std::to_string(graph_number) +
-             ", Traversal Finished, Paths: [  \n");
-  log_paths(logger, paths);
-  logger.log("]\n");
-}
-
-void write_to_file(const GraphPrinter& graph_printer,
-                   const std::string& filename) {
-  std::ofstream jsonfile(filename, std::ios::out);
-  if (!jsonfile.is_open())
-    throw std::runtime_error("Error while opening the JSON file!");
-  jsonfile << graph_printer.print();
-  jsonfile.close();
-}
-
-void prepare_temp_directory() {
-  std::filesystem::create_directory("./temp");
-}
-
-Logger& prepare_logger() {
-  auto& logger = Logger::get_logger();
-  logger.set_file("./temp/log.txt");
-  return logger;
-}
-
-void traverse_graphs(const std::vector<Graph>& graphs) {
-  auto traversal_controller = GraphTraversalController(graphs);
-
-  traversal_controller.traverse(
-      [](int index, const Graph& traversed_graph) {
-        auto& logger = Logger::get_logger();
-        log_traversal_start(logger, index);
-      },
-      [](int index, const Graph& traversed_graph,
-         std::vector<GraphTraverser::Path> paths) {
-        auto& logger = Logger::get_logger();
-        log_traversal_end(logger, index, paths);
-      });
-}
-
-int main() {
-  const int threads_count = handle_threads_count_input();
-  const int graphs_count = handle_graphs_count_input();
-  const int max_depth = handle_depth_input();
-  const int new_vertices_num = handle_new_vertices_num_input();
-
-  const auto params = GraphGenerator::Params(max_depth, new_vertices_num);
-  auto graphs = std::vector<Graph>();
-  auto generation_controller =
-      GraphGenerationController(threads_count, graphs_count, params);
-
-  prepare_temp_directory();
-  auto& logger = prepare_logger();
-
-  graphs.reserve(graphs_count);
-  generation_controller.generate(
-      [&logger](int index) { log_start(logger, index); },
-      [&logger, &graphs](int index, Graph graph) {
-        log_end(logger, graph, index);
-        graphs.push_back(graph);
-        const auto graph_printer = GraphPrinter(graph);
-        write_to_file(graph_printer,
-                      "./temp/graph_" + std::to_string(index) + ".json");
-      });
-
-  traverse_graphs(graphs);
-
-  return 0;
-}
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "graph.hpp"
+#include "graph_generation_controller.hpp"
+#include "graph_pool.hpp"
+#include "graph_printer.hpp"
+#include "graph_traversal.hpp"
+#include "graph_traversal_controller.hpp"
+#include "logger.hpp"
+
+using Graph = uni_cpp_practice::Graph;
+using Edge = uni_cpp_practice::Edge;
+using GraphPrinter = uni_cpp_practice::GraphPrinter;
+using GraphGenerator = uni_cpp_practice::GraphGenerator;
+using GraphGenerationController = uni_cpp_practice::GraphGenerationController;
+using GraphPool = uni_cpp_practice::GraphPool;
+using Logger = uni_cpp_practice::Logger;
+using GraphTraverser = uni_cpp_practice::GraphTraverser;
+using GraphTraversalController = uni_cpp_practice::GraphTraversalController;
+
+std::string get_date_and_time() {
+  std::time_t now =
+      std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  std::stringstream date_time_string;
+  date_time_string << std::put_time(std::localtime(&now), "%d/%m/%Y %T");
+  return date_time_string.str();
+}
+
+int handle_depth_input() {
+  int max_depth = 0;
+  std::cout << "Enter max_depth: ";
+  do {
+    std::cin >> max_depth;
+    if (max_depth < 0)
+      std::cerr << "Depth can not be negative!\n"
+                   "Enter a non-negative max_depth: ";
+  } while (max_depth < 0);
+  return max_depth;
+}
+
+int handle_new_vertices_num_input() {
+  int new_vertices_num = 0;
+  std::cout << "Enter new_vertices_num: ";
+  do {
+    std::cin >> new_vertices_num;
+    if (new_vertices_num < 0)
+      std::cerr << "Number of new vertices created by each vertex can not be "
+                   "negative!\nEnter a non-negative new_vertices_num: ";
+  } while (new_vertices_num < 0);
+  return new_vertices_num;
+}
+
+int handle_threads_count_input() {
+  int threads_count = 0;
+  std::cout << "Enter threads_count: ";
+  do {
+    std::cin >> threads_count;
+    if (threads_count < 0)
+      std::cerr << "Count of threads can not be negative!\n"
+                   "Enter a non-negative threads_count: ";
+  } while (threads_count < 0);
+  return threads_count;
+}
+
+int handle_graphs_count_input() {
+  int graphs_count = 0;
+  std::cout << "Enter graphs_count: ";
+  do {
+    std::cin >> graphs_count;
+    if (graphs_count < 0)
+      std::cerr << "Count of graphs to be created can not be negative!\n"
+                   "Enter a non-negative graphs_count: ";
+  } while (graphs_count < 0);
+  return graphs_count;
+}
+
+// Only plain decimal digits, std::stoull() alone would also take leading
+// spaces, a minus sign that wraps around and anything after the number.
+std::optional<std::uint64_t> parse_seed(const std::string& text) {
+  if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0])))
+    return std::nullopt;
+  try {
+    std::size_t length = 0;
+    const auto seed = std::stoull(text, &length);
+    if (length == text.size())
+      return seed;
+  } catch (const std::out_of_range&) {
+  }
+  return std::nullopt;
+}
+
+// A seed given in UNI_CPP_PRACTICE_SEED, like one logged by an earlier run,
+// generates the same graphs again. Without it the seed is random.
+std::uint64_t get_seed() {
+  const char* const seed_text = std::getenv("UNI_CPP_PRACTICE_SEED");
+  if (seed_text != nullptr) {
+    const auto seed = parse_seed(seed_text);
+    if (seed.has_value())
+      return seed.value();
+    std::cerr << "UNI_CPP_PRACTICE_SEED is not a 64-bit unsigned number: \""
+              << seed_text << "\", using a random seed!\n";
+  }
+  return std::random_device()();
+}
+
+void log_start(Logger& logger, const int graph_number) {
+  logger.log(get_date_and_time() + ": Graph " + std::to_string(graph_number) +
+             ", Generation Started\n");
+}
+
+void log_depth(Logger& logger, const Graph& graph) {
+  for (int j = 0; j <= graph.depth(); j++) {
+    logger.log(std::to_string(graph.get_vertices_in_depth(j).size()));
+    if (j != graph.depth())
+      logger.log(", ");
+  }
+}
+
+void log_colors(Logger& logger, const Graph& graph) {
+  const auto& colors = Edge::COLORS;
+  for (std::size_t i = 0; i < colors.size(); i++) {
+    logger.log(uni_cpp_practice::color_to_string(colors[i]) + ": " +
+               std::to_string(graph.get_colored_edges(colors[i]).size()));
+    if (i + 1 != colors.size())
+      logger.log(", ");
+  }
+}
+
+void log_memory_usage(Logger& logger, const Graph::MemoryUsage& usage) {
+  logger.log("  memory: " + std::to_string(usage.total()) + " bytes, {" +
+             "vertices: " + std::to_string(usage.vertices) +
+             ", edges: " + std::to_string(usage.edges) +
+             ", vertex edge ids: " + std::to_string(usage.vertex_edge_ids) +
+             ", depths: " + std::to_string(usage.depths) +
+             ", colored edges: " + std::to_string(usage.colored_edges) +
+             ", other: " + std::to_string(usage.other) + "}");
+}
+
+void log_end(Logger& logger, const Graph& graph, int graph_number) {
+  logger.log(get_date_and_time() + ": Graph " + std::to_string(graph_number) +
+             ", Generation Finished {  \n");
+  logger.log("  depth: " + std::to_string(graph.depth()) + ",\n");
+  logger.log("  vertices: " + std::to_string(graph.vertices_count()) +
+             ", [");
+  log_depth(logger, graph);
+  logger.log("],\n  edges: " + std::to_string(graph.edges_count()) +
+             ", {");
+  log_colors(logger, graph);
+  logger.log("},\n");
+  log_memory_usage(logger, graph.memory_usage());
+  logger.log("\n}\n");
+}
+
+void log_graphs_memory_usage(
+    Logger& logger,
+    const std::vector<std::shared_ptr<const Graph>>& graphs) {
+  auto bytes = std::size_t{0};
+  for (const auto& graph : graphs) {
+    bytes += graph->memory_usage().total();
+  }
+  logger.log(get_date_and_time() + ": Memory used by " +
+             std::to_string(graphs.size()) +
+             " graphs: " + std::to_string(bytes) + " bytes\n");
+}
+
+void log_graph_pool_statistics(Logger& logger,
+                               const GraphPool::Statistics& statistics) {
+  const auto hit_rate =
+      statistics.acquired_count == 0
+          ? 0
+          : statistics.reused_count * 100 / statistics.acquired_count;
+  logger.log(get_date_and_time() + ": Graph pool: reused " +
+             std::to_string(statistics.reused_count) + " of " +
+             std::to_string(statistics.acquired_count) + " graphs (" +
+             std::to_string(hit_rate) + "%), bytes saved: " +
+             std::to_string(statistics.reused_bytes) + "\n");
+}
+
+void log_paths(Logger& logger, const std::vector<GraphTraverser::Path>& paths) {
+  for (std::size_t i = 0; i < paths.size(); i++) {
+    logger.log(GraphPrinter::print_path(paths[i]));
+    if (i != paths.size() - 1)
+      logger.log(",");
+    logger.log("\n");
+  }
+}
+
+void log_traversal_start(Logger& logger, int graph_number) {
+  logger.log(get_date_and_time() + ": Graph " + std::to_string(graph_number) +
+             ", Traversal Started\n");
+}
+
+void log_traversal_end(Logger& logger,
+                       const int graph_number,
+                       const std::vector<GraphTraverser::Path>& paths) {
+  logger.log(get_date_and_time() + ": Graph " + std::to_string(graph_number) +
+             ", Traversal Finished, Paths: [  \n");
+  log_paths(logger, paths);
+  logger.log("]\n");
+}
+
+void write_to_file(const GraphPrinter& graph_printer,
+                   const std::string& filename) {
+  std::ofstream jsonfile(filename, std::ios::out);
+  if (!jsonfile.is_open())
+    throw std::runtime_error("Error while opening the JSON file!");
+  jsonfile << graph_printer.print();
+  jsonfile.close();
+}
+
+void prepare_temp_directory() {
+  std::filesystem::create_directory("./temp");
+}
+
+Logger& prepare_logger() {
+  auto& logger = Logger::get_logger();
+  logger.set_file("./temp/log.txt");
+  return logger;
+}
+
+void traverse_graphs(const std::vector<std::shared_ptr<const Graph>>& graphs) {
+  auto traversal_controller = GraphTraversalController(graphs);
+
+  traversal_controller.traverse(
+      [](int index, const Graph& traversed_graph) {
+        auto& logger = Logger::get_logger();
+        log_traversal_start(logger, index);
+      },
+      [](int index, const Graph& traversed_graph,
+         std::vector<GraphTraverser::Path> paths) {
+        auto& logger = Logger::get_logger();
+        log_traversal_end(logger, index, paths);
+      });
+}
+
+int main() {
+  const int threads_count = handle_threads_count_input();
+  const int graphs_count = handle_graphs_count_input();
+  const int max_depth = handle_depth_input();
+  const int new_vertices_num = handle_new_vertices_num_input();
+
+  const auto seed = get_seed();
+  const auto params =
+      GraphGenerator::Params(max_depth, new_vertices_num, seed);
+  auto graphs = std::vector<std::shared_ptr<const Graph>>();
+  auto generation_controller =
+      GraphGenerationController(threads_count, graphs_count, params);
+
+  prepare_temp_directory();
+  auto& logger = prepare_logger();
+  logger.log(get_date_and_time() + ": Seed: " + std::to_string(seed) + "\n");
+
+  graphs.reserve(graphs_count);
+  generation_controller.generate(
+      [&logger](int index) { log_start(logger, index); },
+      [&logger, &graphs](int index, std::shared_ptr<const Graph> graph) {
+        log_end(logger, *graph, index);
+        graphs.push_back(graph);
+        const auto graph_printer = GraphPrinter(*graph);
+        write_to_file(graph_printer,
+                      "./temp/graph_" + std::to_string(index) + ".json");
+      });
+  log_graphs_memory_usage(logger, graphs);
+
+  traverse_graphs(graphs);
+
+  // The graphs go back to the pool, which counts the memory they reused.
+  graphs.clear();
+  log_graph_pool_statistics(logger,
+                            generation_controller.get_graph_pool_statistics());
+
+  return 0;
+}
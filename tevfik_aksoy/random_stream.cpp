@@ -0,0 +1,78 @@
+#include "random_stream.hpp"
+#include <algorithm>
+#include <cassert>
+#include <random>
+
+namespace {
+constexpr std::uint64_t GOLDEN_GAMMA = 0x9e3779b97f4a7c15;
+// Fewer trials are cheaper to run one by one than to draw their count.
+constexpr int MIN_BINOMIAL_TRIALS_COUNT = 100;
+
+// Finalizer of SplitMix64: every bit of the result depends on every bit of
+// `value`.
+std::uint64_t mix(std::uint64_t value) {
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+  return value ^ (value >> 31);
+}
+
+// Two rounds, so that neighbouring keys and counters give unrelated
+// numbers.
+std::uint64_t get_number(std::uint64_t key, std::uint64_t counter) {
+  return mix(mix(key + counter * GOLDEN_GAMMA) ^ key);
+}
+
+float to_probability(std::uint64_t number) {
+  // The 24 high bits fill the mantissa of a float exactly.
+  return static_cast<float>(number >> 40) * (1.0f / (1 << 24));
+}
+}  // namespace
+
+namespace uni_cpp_practice {
+
+RandomStream::RandomStream(std::uint64_t seed) : key_(mix(seed)) {}
+
+RandomStream RandomStream::get_substream(std::uint64_t index) const {
+  return RandomStream(Key(), mix(key_ ^ mix((index + 1) * GOLDEN_GAMMA)));
+}
+
+std::uint64_t RandomStream::get_number() {
+  return ::get_number(key_, ++counter_);
+}
+
+float RandomStream::get_probability() {
+  return to_probability(get_number());
+}
+
+void RandomStream::get_probabilities(float* first, float* last) {
+  const auto key = key_;
+  const auto counter = counter_ + 1;
+  const std::uint64_t count = last - first;
+  for (std::uint64_t i = 0; i < count; i++) {
+    first[i] = to_probability(::get_number(key, counter + i));
+  }
+  counter_ += count;
+}
+
+int RandomStream::get_binomial(int trials_count, float probability) {
+  // Setting up the distribution costs about as much as a hundred trials.
+  if (trials_count < MIN_BINOMIAL_TRIALS_COUNT) {
+    int successes_count = 0;
+    for (int i = 0; i < trials_count; i++) {
+      if (get_probability() < probability)
+        successes_count++;
+    }
+    return successes_count;
+  }
+  // The distribution is implemented by the standard library, so the counts
+  // drawn from a stream may differ between standard libraries.
+  return std::binomial_distribution<int>(
+      trials_count, std::clamp(probability, 0.0f, 1.0f))(*this);
+}
+
+std::uint64_t RandomStream::get_index(std::uint64_t count) {
+  assert(count > 0 && "Can't pick from nothing!");
+  // The bias of the modulo is negligible for counts far below 2^64.
+  return get_number() % count;
+}
+}  // namespace uni_cpp_practice
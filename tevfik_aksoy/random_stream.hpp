@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+namespace uni_cpp_practice {
+// Counter-based random number generator: the n-th number of a stream is a
+// hash of the stream key and n, so a stream has no state to seed but its
+// key and a counter. Independent substreams are derived from a stream by
+// key, which makes the numbers a piece of work gets depend only on where it
+// is, not on which thread runs it or when.
+//
+// Also a UniformRandomBitGenerator, for the distributions of <random>.
+class RandomStream {
+ public:
+  using result_type = std::uint64_t;
+
+  explicit RandomStream(std::uint64_t seed);
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return UINT64_MAX; }
+  result_type operator()() { return get_number(); }
+
+  // Stream number `index` of this stream, independent of it and of the
+  // other substreams.
+  RandomStream get_substream(std::uint64_t index) const;
+
+  std::uint64_t get_number();
+  // Uniform in [0, 1).
+  float get_probability();
+  // Fills [first, last) with the same numbers as that many calls of
+  // get_probability(). They don't depend on each other, so they are
+  // computed without a loop-carried dependency and the compiler may
+  // vectorize the loop.
+  void get_probabilities(float* first, float* last);
+  // Count of successes of `trials_count` trials that each succeed with
+  // `probability`. Many trials take one draw, however many they are.
+  int get_binomial(int trials_count, float probability);
+  // Uniform in [0, count), `count` must not be 0.
+  std::uint64_t get_index(std::uint64_t count);
+
+ private:
+  struct Key {};
+  RandomStream(Key, std::uint64_t key) : key_(key) {}
+
+  std::uint64_t key_ = 0;
+  std::uint64_t counter_ = 0;
+};
+}  // namespace uni_cpp_practice
@@ -0,0 +1,137 @@
+#include "task_scheduler.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace {
+// Scheduler and worker the current thread runs tasks of.
+thread_local const uni_cpp_practice::TaskScheduler* current_scheduler =
+    nullptr;
+thread_local int current_worker_index = -1;
+}  // namespace
+
+namespace uni_cpp_practice {
+
+thread_local TaskScheduler::Run* TaskScheduler::current_run_ = nullptr;
+
+TaskScheduler::TaskScheduler(int threads_count)
+    : threads_count_(threads_count > 0
+                         ? threads_count
+                         : std::max(1u, std::thread::hardware_concurrency())),
+      workers_(new Worker[threads_count_]) {
+  threads_.reserve(threads_count_);
+  for (int i = 0; i < threads_count_; i++) {
+    threads_.emplace_back([this, i]() {
+      current_scheduler = this;
+      current_worker_index = i;
+      work(i);
+    });
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+  {
+    const std::lock_guard lock(sleep_mutex_);
+    should_stop_ = true;
+  }
+  has_jobs_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void TaskScheduler::run(Task task) {
+  assert(current_scheduler != this && "run() is called from a task!");
+  auto run = Run();
+  run.pending_tasks_count = 1;
+  const auto worker_index = next_worker_index_++ % threads_count_;
+  push_job(worker_index, {std::move(task), &run});
+
+  auto lock = std::unique_lock(run.mutex);
+  run.done.wait(lock, [&run]() { return run.pending_tasks_count == 0; });
+}
+
+void TaskScheduler::spawn(Task task) {
+  assert(current_scheduler == this && "Task is spawned outside of run()!");
+  // The spawning task is pending itself, so the count can't drop to 0
+  // meanwhile.
+  ++current_run_->pending_tasks_count;
+  push_job(current_worker_index, {std::move(task), current_run_});
+}
+
+void TaskScheduler::push_job(int worker_index, Job job) {
+  // Counted first, so that a worker that finds the count above 0 keeps
+  // looking until it finds the job instead of going to sleep.
+  ++queued_jobs_count_;
+  {
+    auto& worker = workers_[worker_index];
+    const std::lock_guard lock(worker.mutex);
+    worker.jobs.push_back(std::move(job));
+  }
+  if (sleeping_workers_count_ > 0) {
+    // Taking the mutex makes sure a worker that is about to sleep either
+    // sees the job or is already waiting for the notification.
+    { const std::lock_guard lock(sleep_mutex_); }
+    has_jobs_.notify_one();
+  }
+}
+
+void TaskScheduler::work(int worker_index) {
+  while (true) {
+    auto job = pop_job(worker_index);
+    if (!job.has_value()) {
+      job = steal_job(worker_index);
+    }
+    if (!job.has_value()) {
+      if (!wait_for_jobs()) {
+        return;
+      }
+      continue;
+    }
+    --queued_jobs_count_;
+    current_run_ = job->run;
+    job->task();
+    current_run_ = nullptr;
+    // The waiting run() may return as soon as the count is 0, so the run
+    // is not touched after the mutex is released.
+    const std::lock_guard lock(job->run->mutex);
+    if (--job->run->pending_tasks_count == 0) {
+      job->run->done.notify_all();
+    }
+  }
+}
+
+bool TaskScheduler::wait_for_jobs() {
+  auto lock = std::unique_lock(sleep_mutex_);
+  ++sleeping_workers_count_;
+  has_jobs_.wait(lock, [this]() {
+    return should_stop_ || queued_jobs_count_ > 0;
+  });
+  --sleeping_workers_count_;
+  return !should_stop_;
+}
+
+std::optional<TaskScheduler::Job> TaskScheduler::pop_job(int worker_index) {
+  auto& worker = workers_[worker_index];
+  const std::lock_guard lock(worker.mutex);
+  if (worker.jobs.empty()) {
+    return std::nullopt;
+  }
+  auto job = std::move(worker.jobs.back());
+  worker.jobs.pop_back();
+  return job;
+}
+
+std::optional<TaskScheduler::Job> TaskScheduler::steal_job(int worker_index) {
+  for (int i = 1; i < threads_count_; i++) {
+    auto& victim = workers_[(worker_index + i) % threads_count_];
+    const std::lock_guard lock(victim.mutex);
+    if (victim.jobs.empty()) {
+      continue;
+    }
+    auto job = std::move(victim.jobs.front());
+    victim.jobs.pop_front();
+    return job;
+  }
+  return std::nullopt;
+}
+}  // namespace uni_cpp_practice
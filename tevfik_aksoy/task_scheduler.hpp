@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace uni_cpp_practice {
+// Runs a task and all the tasks it spawns on several threads. Every thread
+// has its own deque of tasks: it takes the tasks it spawned itself from the
+// bottom, newest first, and once it runs out it steals from the top of the
+// others, where the oldest and usually the biggest tasks are. So a task that
+// spawns many more keeps all the threads busy, however unevenly its work is
+// split between them.
+//
+// The threads are created once with the scheduler and sleep while there is
+// nothing to run, so one scheduler can be shared by everything that runs
+// tasks, and run() may be called from several threads at once.
+class TaskScheduler {
+ public:
+  using Task = std::function<void()>;
+
+  // 0 threads means as many as the hardware runs at once.
+  explicit TaskScheduler(int threads_count = 0);
+  TaskScheduler(const TaskScheduler&) = delete;
+  TaskScheduler& operator=(const TaskScheduler&) = delete;
+  // Stops the threads. No run() may be going on anymore.
+  ~TaskScheduler();
+
+  // Returns once `task` and every task spawned by it meanwhile are done.
+  // The calling thread waits without running any of them, so it may not be
+  // one of the threads of the scheduler.
+  void run(Task task);
+  // Queues `task` to run later, as a part of the run() of the calling
+  // task. May only be called from the tasks run().
+  void spawn(Task task);
+
+ private:
+  // Tasks of one call of run() that are not done yet.
+  struct Run {
+    // Only drops to 0 with `mutex` held, so that run() can wait for it.
+    std::atomic<int> pending_tasks_count = 0;
+    std::mutex mutex;
+    std::condition_variable done;
+  };
+
+  struct Job {
+    Task task;
+    Run* run = nullptr;
+  };
+
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  // The run() the task the current thread runs is a part of.
+  static thread_local Run* current_run_;
+
+  const int threads_count_;
+  const std::unique_ptr<Worker[]> workers_;
+  std::vector<std::thread> threads_;
+  // Jobs in the deques of the workers, counted before they are pushed.
+  std::atomic<int> queued_jobs_count_ = 0;
+  // Workers that wait on `has_jobs_` for jobs to be queued.
+  std::atomic<int> sleeping_workers_count_ = 0;
+  // Worker the next run() queues its task to.
+  std::atomic<int> next_worker_index_ = 0;
+  bool should_stop_ = false;
+  std::mutex sleep_mutex_;
+  std::condition_variable has_jobs_;
+
+  void push_job(int worker_index, Job job);
+  void work(int worker_index);
+  std::optional<Job> pop_job(int worker_index);
+  std::optional<Job> steal_job(int worker_index);
+  // Waits until there may be a job to take. Returns false once the
+  // scheduler stops.
+  bool wait_for_jobs();
+};
+}  // namespace uni_cpp_practice